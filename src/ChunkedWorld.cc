@@ -0,0 +1,387 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ChunkedWorld.hh"
+#include "TileMap.hh"
+#include "Tile.hh"
+#include "LTexture.hh"
+
+#define TOTAL_TILE_SPRITES (12)
+
+// Division rounding down, so cells left of or above the map come out negative
+static int floorDivide(int value, int divisor) {
+	int quotient = value / divisor;
+	return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+ChunkedWorld::ChunkedWorld() {
+	mFile = -1;
+	mColumns = 0;
+	mRows = 0;
+	mTileWidth = 0;
+	mTileHeight = 0;
+	mChunkSize = 0;
+	mChunkColumns = 0;
+	mChunkRows = 0;
+	mMaxChunks = 0;
+	mLastKey = NO_CHUNK;
+	mLastChunk = NULL;
+	mLoading = NO_CHUNK;
+	mQuit = false;
+}
+
+ChunkedWorld::~ChunkedWorld() {
+	close();
+}
+
+/**
+ * Read the header of a chunked binary map and start the loader thread
+ * No tiles are read until update asks for the chunks around the camera
+ */
+bool ChunkedWorld::open(std::string path, size_t memoryBudget) {
+	close();
+
+	mFile = ::open(path.c_str(), O_RDONLY);
+	if (mFile < 0) {
+		std::cout << "Unable to open map (" << path << "): " << strerror(errno) << '\n';
+		return false;
+	}
+
+	TileMapHeader header;
+	if (pread(mFile, &header, sizeof(header), 0) != sizeof(header) ||
+			memcmp(header.magic, "LMAP", 4) != 0 || header.version != TileMap::BINARY_VERSION ||
+			header.tileWidth == 0 || header.tileHeight == 0) {
+		std::cout << "Not a supported binary map (" << path << ")\n";
+		close();
+		return false;
+	}
+	if (header.columns == 0 || header.rows == 0 || header.columns > INT_MAX ||
+			header.rows > INT_MAX || (Uint64) header.columns * header.tileWidth > INT_MAX ||
+			(Uint64) header.rows * header.tileHeight > INT_MAX) {
+		std::cout << "Invalid map size in binary map (" << path << ")\n";
+		close();
+		return false;
+	}
+	if (header.chunkSize == 0) {
+		std::cout << "Map is not chunked, convert it with a chunk size (" << path << ")\n";
+		close();
+		return false;
+	}
+
+	mColumns = header.columns;
+	mRows = header.rows;
+	mTileWidth = header.tileWidth;
+	mTileHeight = header.tileHeight;
+	mChunkSize = header.chunkSize;
+	mChunkColumns = (mColumns + mChunkSize - 1) / mChunkSize;
+	mChunkRows = (mRows + mChunkSize - 1) / mChunkSize;
+	mMaxChunks = std::max(memoryBudget / ((size_t) mChunkSize * mChunkSize), (size_t) 1);
+
+	mQuit = false;
+	mLoader = std::thread(&ChunkedWorld::loadChunks, this);
+	return true;
+}
+
+// Stop the loader thread and release every chunk
+void ChunkedWorld::close() {
+	if (mLoader.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mQuit = true;
+		}
+		mWake.notify_all();
+		mLoader.join();
+	}
+
+	if (mFile >= 0) {
+		::close(mFile);
+		mFile = -1;
+	}
+
+	mResident.clear();
+	mRequests.clear();
+	mFinished.clear();
+	mSpareBuffers.clear();
+	mFailed.clear();
+	mLastKey = NO_CHUNK;
+	mLastChunk = NULL;
+	mLoading = NO_CHUNK;
+	mColumns = 0;
+	mRows = 0;
+	mChunkColumns = 0;
+	mChunkRows = 0;
+}
+
+/**
+ * Take in chunks the loader has finished, queue the missing chunks around the
+ * camera nearest first, and drop the farthest chunks outside that area to
+ * make room for them. Resident, loading, queued and spare chunks together
+ * never exceed the budget. Only list operations happen here, all file reads
+ * are done on the loader thread.
+ */
+void ChunkedWorld::update(SDL_Rect& camera) {
+	if (mFile < 0) {
+		return;
+	}
+
+	int firstCol, lastCol, firstRow, lastRow;
+	getCellRange(camera, &firstCol, &lastCol, &firstRow, &lastRow);
+	int firstChunkX = std::max(firstCol / mChunkSize - PREFETCH_CHUNKS, 0);
+	int lastChunkX = std::min(lastCol / mChunkSize + PREFETCH_CHUNKS, mChunkColumns - 1);
+	int firstChunkY = std::max(firstRow / mChunkSize - PREFETCH_CHUNKS, 0);
+	int lastChunkY = std::min(lastRow / mChunkSize + PREFETCH_CHUNKS, mChunkRows - 1);
+
+	// Distances are measured in chunks from the chunk at the camera's center
+	int centerX = (camera.x + camera.w / 2) / (mTileWidth * mChunkSize);
+	int centerY = (camera.y + camera.h / 2) / (mTileHeight * mChunkSize);
+	auto distance = [centerX, centerY](ChunkKey key) {
+		int dX = (int) (key & 0xffffffff) - centerX;
+		int dY = (int) (key >> 32) - centerY;
+		return dX * dX + dY * dY;
+	};
+
+	bool requested = false;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		for (auto & finished: mFinished) {
+			mResident[finished.first].swap(finished.second);
+			if (finished.second.capacity() > 0) { // Already had this chunk
+				mSpareBuffers.push_back(std::move(finished.second));
+			}
+		}
+		mFinished.clear();
+
+		// Replace the queue so chunks the camera has left are not loaded
+		mRequests.clear();
+		for (int chunkY = firstChunkY; chunkY <= lastChunkY; chunkY++) {
+			for (int chunkX = firstChunkX; chunkX <= lastChunkX; chunkX++) {
+				ChunkKey key = makeKey(chunkX, chunkY);
+				if (key != mLoading && mResident.find(key) == mResident.end() &&
+						mFailed.find(key) == mFailed.end()) {
+					mRequests.push_back(key);
+				}
+			}
+		}
+		std::sort(mRequests.begin(), mRequests.end(), [&distance](ChunkKey a, ChunkKey b) {
+			return distance(a) < distance(b);
+		});
+
+		// Only request what fits next to the chunks already in the area, so the
+		// budget holds even when the area needs more chunks than it allows
+		size_t inside = 0;
+		for (auto & chunk: mResident) {
+			int chunkX = chunk.first & 0xffffffff;
+			int chunkY = chunk.first >> 32;
+			if (chunkX >= firstChunkX && chunkX <= lastChunkX &&
+					chunkY >= firstChunkY && chunkY <= lastChunkY) {
+				inside++;
+			}
+		}
+		size_t loading = mLoading != NO_CHUNK ? 1 : 0;
+		size_t room = mMaxChunks > inside + loading ? mMaxChunks - inside - loading : 0;
+		if (mRequests.size() > room) {
+			mRequests.resize(room);
+		}
+		requested = !mRequests.empty();
+
+		// Make room for the requested chunks by dropping the farthest ones
+		// outside the area
+		if (mResident.size() + loading + mRequests.size() > mMaxChunks) {
+			std::vector<ChunkKey> outside;
+			for (auto & chunk: mResident) {
+				int chunkX = chunk.first & 0xffffffff;
+				int chunkY = chunk.first >> 32;
+				if (chunkX < firstChunkX || chunkX > lastChunkX ||
+						chunkY < firstChunkY || chunkY > lastChunkY) {
+					outside.push_back(chunk.first);
+				}
+			}
+			std::sort(outside.begin(), outside.end(), [&distance](ChunkKey a, ChunkKey b) {
+				return distance(a) > distance(b);
+			});
+
+			for (size_t i = 0; i < outside.size() &&
+					 mResident.size() + loading + mRequests.size() > mMaxChunks; i++) {
+				auto chunk = mResident.find(outside[i]);
+				mSpareBuffers.push_back(std::move(chunk->second));
+				mResident.erase(chunk);
+			}
+		}
+
+		// Spare buffers are memory too, only keep what fits in the budget
+		// Requests are filled from them first, so they never add to it
+		while (!mSpareBuffers.empty() &&
+					 mResident.size() + loading + mSpareBuffers.size() > mMaxChunks) {
+			mSpareBuffers.pop_back();
+		}
+	}
+
+	if (requested) {
+		mWake.notify_one();
+	}
+
+	// Resident chunks may have changed
+	mLastKey = NO_CHUNK;
+	mLastChunk = NULL;
+}
+
+/**
+ * Work out which columns and rows the camera overlaps and draw the ones that
+ * are loaded, batched into a single draw call
+ */
+void ChunkedWorld::render(SDL_Renderer* renderer, SDL_Rect& camera,
+													LTexture* tileTexture, SDL_Rect* tileClips) {
+	if (mFile < 0) {
+		return;
+	}
+
+	int firstCol, lastCol, firstRow, lastRow;
+	getCellRange(camera, &firstCol, &lastCol, &firstRow, &lastRow);
+
+	for (int row = firstRow; row <= lastRow; row++) {
+		for (int col = firstCol; col <= lastCol; col++) {
+			int type = typeAt(col, row);
+			if (type >= 0) {
+				mBatch.draw(renderer, tileTexture, col * mTileWidth - camera.x,
+										row * mTileHeight - camera.y, &tileClips[type]);
+			}
+		}
+	}
+	mBatch.flush(renderer);
+}
+
+// Check if given rectangle collides with any wall tiles or unloaded chunks
+bool ChunkedWorld::touchesWall(SDL_Rect& box) {
+	if (mFile < 0) {
+		return true;
+	}
+
+	int firstCol, lastCol, firstRow, lastRow;
+	getCellRange(box, &firstCol, &lastCol, &firstRow, &lastRow);
+
+	for (int row = firstRow; row <= lastRow; row++) {
+		for (int col = firstCol; col <= lastCol; col++) {
+			int type = typeAt(col, row);
+			if (type < 0 || (type >= TILE_CENTER && type <= TILE_TOPLEFT)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// Getters
+int ChunkedWorld::getLevelWidth() {
+	return mColumns * mTileWidth;
+}
+
+int ChunkedWorld::getLevelHeight() {
+	return mRows * mTileHeight;
+}
+
+int ChunkedWorld::getResidentChunks() {
+	return mResident.size();
+}
+
+/**
+ * Wait for requests and read one chunk at a time
+ * The lock is only held to pick a request and to hand the chunk back.
+ * Chunks are checked here so the main thread can index clips with any tile.
+ */
+void ChunkedWorld::loadChunks() {
+	size_t chunkBytes = (size_t) mChunkSize * mChunkSize;
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (true) {
+		mWake.wait(lock, [this]() { return mQuit || !mRequests.empty(); });
+		if (mQuit) {
+			return;
+		}
+
+		ChunkKey key = mRequests.front();
+		mRequests.pop_front();
+		mLoading = key;
+
+		std::vector<Uint8> buffer;
+		if (!mSpareBuffers.empty()) {
+			buffer.swap(mSpareBuffers.back());
+			mSpareBuffers.pop_back();
+		}
+		lock.unlock();
+
+		buffer.resize(chunkBytes);
+		size_t chunkIndex = (key >> 32) * mChunkColumns + (key & 0xffffffff);
+		off_t offset = sizeof(TileMapHeader) + chunkIndex * chunkBytes;
+
+		bool success = true;
+		size_t done = 0;
+		while (done < chunkBytes) {
+			ssize_t count = pread(mFile, buffer.data() + done, chunkBytes - done, offset + done);
+			if (count <= 0) {
+				std::cout << "Unable to read map chunk: " << (count < 0 ? strerror(errno) : "end of file") << '\n';
+				success = false;
+				break;
+			}
+			done += count;
+		}
+		for (size_t i = 0; i < chunkBytes && success; i++) {
+			if (buffer[i] >= TOTAL_TILE_SPRITES) {
+				std::cout << "Invalid Tile Type in map chunk at " << i << '\n';
+				success = false;
+			}
+		}
+
+		lock.lock();
+		mLoading = NO_CHUNK;
+		if (success) {
+			mFinished.emplace_back(key, std::move(buffer));
+		} else {
+			mFailed.insert(key);
+			mSpareBuffers.push_back(std::move(buffer));
+		}
+	}
+}
+
+ChunkedWorld::ChunkKey ChunkedWorld::makeKey(int chunkX, int chunkY) {
+	return ((ChunkKey) chunkY << 32) | (Uint32) chunkX;
+}
+
+// Look up a loaded chunk, remembering the last one since neighbouring tiles
+// usually share it
+const Uint8* ChunkedWorld::findChunk(int chunkX, int chunkY) {
+	ChunkKey key = makeKey(chunkX, chunkY);
+	if (key != mLastKey) {
+		auto chunk = mResident.find(key);
+		mLastKey = key;
+		mLastChunk = chunk == mResident.end() ? NULL : chunk->second.data();
+	}
+	return mLastChunk;
+}
+
+int ChunkedWorld::typeAt(int col, int row) {
+	const Uint8* chunk = findChunk(col / mChunkSize, row / mChunkSize);
+	if (chunk == NULL) {
+		return -1;
+	}
+	return chunk[(row % mChunkSize) * mChunkSize + col % mChunkSize];
+}
+
+// Clamp the cells under the rectangle to the map
+// An empty range (first > last) is returned when the rectangle is off the map
+void ChunkedWorld::getCellRange(SDL_Rect& box, int* firstCol, int* lastCol,
+																int* firstRow, int* lastRow) {
+	*firstCol = std::max(floorDivide(box.x, mTileWidth), 0);
+	*lastCol = std::min(floorDivide(box.x + box.w - 1, mTileWidth), mColumns - 1);
+	*firstRow = std::max(floorDivide(box.y, mTileHeight), 0);
+	*lastRow = std::min(floorDivide(box.y + box.h - 1, mTileHeight), mRows - 1);
+}
@@ -0,0 +1,97 @@
+#ifndef CHUNKEDWORLD
+#define CHUNKEDWORLD
+
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "LTexture.hh"
+#include "LSpriteBatch.hh"
+#include "Tile.hh"
+
+// Tile world streamed from a chunked binary map (see TileMapHeader)
+// Only the chunks around the camera are kept in memory. A background thread
+// reads chunks ahead of the camera and chunks far from it are dropped once
+// the memory budget is reached, so memory stays flat for any map size. If the
+// area around the camera needs more chunks than the budget holds, only the
+// ones nearest its center are loaded.
+//
+// Queries are made from the main thread only. Tiles in chunks that are not
+// loaded are not drawn and count as walls, so nothing can move into them.
+// Chunks that cannot be read or hold invalid tiles stay that way for good.
+class ChunkedWorld {
+	public:
+		// Chunks loaded past each side of the camera
+		static const int PREFETCH_CHUNKS = 1;
+
+		ChunkedWorld();
+		~ChunkedWorld();
+
+		bool open(std::string, size_t); // Path, memory budget in bytes
+		void close();
+
+		// Request chunks around the camera and drop distant ones
+		// Call once per frame before moving or rendering
+		void update(SDL_Rect&);
+
+		// Render the loaded tiles the camera can see
+		void render(SDL_Renderer*, SDL_Rect&, LTexture*, SDL_Rect*);
+
+		bool touchesWall(SDL_Rect&); // Check box against wall tiles under it
+
+		// Getters
+		int getLevelWidth();
+		int getLevelHeight();
+		int getResidentChunks();
+
+	private:
+		// Chunks are keyed by their chunk coordinates packed into 64 bits
+		typedef Uint64 ChunkKey;
+		static const ChunkKey NO_CHUNK = ~0ULL;
+
+		int mFile;
+		int mColumns;
+		int mRows;
+		int mTileWidth;
+		int mTileHeight;
+		int mChunkSize;
+		int mChunkColumns;
+		int mChunkRows;
+		size_t mMaxChunks; // Memory budget in chunks, resident and spare
+
+		// Loaded chunks, only touched by the main thread
+		std::unordered_map<ChunkKey, std::vector<Uint8>> mResident;
+		ChunkKey mLastKey; // Cache of the most recent lookup
+		const Uint8* mLastChunk;
+
+		// Shared with the loader thread, guarded by mMutex
+		std::mutex mMutex;
+		std::condition_variable mWake;
+		std::deque<ChunkKey> mRequests; // Nearest chunk first
+		std::vector<std::pair<ChunkKey, std::vector<Uint8>>> mFinished;
+		std::vector<std::vector<Uint8>> mSpareBuffers; // Reused by evicted chunks
+		std::unordered_set<ChunkKey> mFailed; // Never requested again
+		ChunkKey mLoading;
+		bool mQuit;
+
+		std::thread mLoader;
+
+		LSpriteBatch mBatch; // Visible tiles are drawn as one batch
+
+		void loadChunks(); // Loader thread body
+
+		ChunkKey makeKey(int, int);
+		const Uint8* findChunk(int, int); // Chunk column, row
+		int typeAt(int, int); // Tile column, row, or -1 when not loaded
+
+		// Range of tile cells covered by the given rectangle
+		void getCellRange(SDL_Rect&, int*, int*, int*, int*);
+};
+#endif
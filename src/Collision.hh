@@ -0,0 +1,185 @@
+#ifndef COLLISIONCHECKS
+#define COLLISIONCHECKS
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "MultiRectCollider.hh"
+
+// Collision checks between circles and rectangles
+// Everything stays in integers: distances are compared squared against the
+// squared radii. The single checks are constexpr and pick closest points with
+// min and max instead of branches. The batch checks test one shape against an
+// array of others, four at a time with SSE2 when the compiler targets it,
+// writing 1 or 0 per shape to hits and returning how many were hit.
+//
+// Shapes only touching along an edge do not collide. Coordinates must stay
+// within 32767 of each other so squared distances fit in an int.
+
+typedef struct Circle {
+	int x;
+	int y;
+	int r;
+} Circle;
+
+constexpr int distanceSquared(int x1, int y1, int x2, int y2) {
+	return (x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1);
+}
+
+constexpr bool circlesCollide(const Circle& a, const Circle& b) {
+	return distanceSquared(a.x, a.y, b.x, b.y) < (a.r + b.r) * (a.r + b.r);
+}
+
+// Compares against the closest point of the box to the circle's center
+constexpr bool circleCollidesRect(const Circle& a, const SDL_Rect& b) {
+	return distanceSquared(a.x, a.y, std::min(std::max(a.x, b.x), b.x + b.w),
+												 std::min(std::max(a.y, b.y), b.y + b.h)) < a.r * a.r;
+}
+
+constexpr bool rectsCollide(const SDL_Rect& a, const SDL_Rect& b) {
+	return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// Rejects on the bounds first, then skips rects outside the other's bounds
+inline bool multiRectsCollide(const MultiRectCollider& a, const MultiRectCollider& b) {
+	const SDL_Rect& bBounds = b.getBounds();
+	if (!rectsCollide(a.getBounds(), bBounds)) {
+		return false;
+	}
+
+	for (auto & rectA: a.getRects()) {
+		if (!rectsCollide(rectA, bBounds)) {
+			continue;
+		}
+		for (auto & rectB: b.getRects()) {
+			if (rectsCollide(rectA, rectB)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+#ifdef __SSE2__
+// Helpers for the batch checks, SSE2 lacks 32 bit multiply, min and max
+
+// Low 32 bits of each product, multiplying the even and odd lanes apart
+inline __m128i collisionMultiply(__m128i a, __m128i b) {
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+														_mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+inline __m128i collisionClamp(__m128i value, __m128i low, __m128i high) {
+	__m128i below = _mm_cmplt_epi32(value, low);
+	value = _mm_or_si128(_mm_and_si128(below, low), _mm_andnot_si128(below, value));
+	__m128i above = _mm_cmpgt_epi32(value, high);
+	return _mm_or_si128(_mm_and_si128(above, high), _mm_andnot_si128(above, value));
+}
+
+// Four rects loaded and transposed into one field per register
+inline void collisionLoadRects(const SDL_Rect* rects, __m128i& x, __m128i& y, __m128i& w,
+															 __m128i& h) {
+	static_assert(sizeof(SDL_Rect) == 16, "SDL_Rect must be four packed ints");
+	__m128i r0 = _mm_loadu_si128((const __m128i*) (rects + 0));
+	__m128i r1 = _mm_loadu_si128((const __m128i*) (rects + 1));
+	__m128i r2 = _mm_loadu_si128((const __m128i*) (rects + 2));
+	__m128i r3 = _mm_loadu_si128((const __m128i*) (rects + 3));
+	__m128i low01 = _mm_unpacklo_epi32(r0, r1);
+	__m128i low23 = _mm_unpacklo_epi32(r2, r3);
+	__m128i high01 = _mm_unpackhi_epi32(r0, r1);
+	__m128i high23 = _mm_unpackhi_epi32(r2, r3);
+	x = _mm_unpacklo_epi64(low01, low23);
+	y = _mm_unpackhi_epi64(low01, low23);
+	w = _mm_unpacklo_epi64(high01, high23);
+	h = _mm_unpackhi_epi64(high01, high23);
+}
+
+// Writes the four lane results as bytes, returns how many were set
+inline size_t collisionStoreHits(__m128i mask, Uint8* hits) {
+	int bits = _mm_movemask_ps(_mm_castsi128_ps(mask));
+	for (int i = 0; i < 4; i++) {
+		hits[i] = (bits >> i) & 1;
+	}
+	return __builtin_popcount(bits);
+}
+#endif
+
+inline size_t circleHits(const Circle& circle, const Circle* others, size_t count, Uint8* hits) {
+	size_t i = 0;
+	size_t hitCount = 0;
+#ifdef __SSE2__
+	__m128i x = _mm_set1_epi32(circle.x);
+	__m128i y = _mm_set1_epi32(circle.y);
+	__m128i r = _mm_set1_epi32(circle.r);
+	for (; i + 4 <= count; i += 4) {
+		const Circle* c = others + i;
+		__m128i dX = _mm_sub_epi32(_mm_set_epi32(c[3].x, c[2].x, c[1].x, c[0].x), x);
+		__m128i dY = _mm_sub_epi32(_mm_set_epi32(c[3].y, c[2].y, c[1].y, c[0].y), y);
+		__m128i rSum = _mm_add_epi32(_mm_set_epi32(c[3].r, c[2].r, c[1].r, c[0].r), r);
+		__m128i distance = _mm_add_epi32(collisionMultiply(dX, dX), collisionMultiply(dY, dY));
+		hitCount += collisionStoreHits(_mm_cmplt_epi32(distance, collisionMultiply(rSum, rSum)),
+																	 hits + i);
+	}
+#endif
+	for (; i < count; i++) {
+		hits[i] = circlesCollide(circle, others[i]);
+		hitCount += hits[i];
+	}
+	return hitCount;
+}
+
+inline size_t circleRectHits(const Circle& circle, const SDL_Rect* rects, size_t count,
+														 Uint8* hits) {
+	size_t i = 0;
+	size_t hitCount = 0;
+#ifdef __SSE2__
+	__m128i cX = _mm_set1_epi32(circle.x);
+	__m128i cY = _mm_set1_epi32(circle.y);
+	__m128i rSquared = _mm_set1_epi32(circle.r * circle.r);
+	for (; i + 4 <= count; i += 4) {
+		__m128i x, y, w, h;
+		collisionLoadRects(rects + i, x, y, w, h);
+		__m128i dX = _mm_sub_epi32(collisionClamp(cX, x, _mm_add_epi32(x, w)), cX);
+		__m128i dY = _mm_sub_epi32(collisionClamp(cY, y, _mm_add_epi32(y, h)), cY);
+		__m128i distance = _mm_add_epi32(collisionMultiply(dX, dX), collisionMultiply(dY, dY));
+		hitCount += collisionStoreHits(_mm_cmplt_epi32(distance, rSquared), hits + i);
+	}
+#endif
+	for (; i < count; i++) {
+		hits[i] = circleCollidesRect(circle, rects[i]);
+		hitCount += hits[i];
+	}
+	return hitCount;
+}
+
+inline size_t rectHits(const SDL_Rect& rect, const SDL_Rect* rects, size_t count, Uint8* hits) {
+	size_t i = 0;
+	size_t hitCount = 0;
+#ifdef __SSE2__
+	__m128i left = _mm_set1_epi32(rect.x);
+	__m128i top = _mm_set1_epi32(rect.y);
+	__m128i right = _mm_set1_epi32(rect.x + rect.w);
+	__m128i bottom = _mm_set1_epi32(rect.y + rect.h);
+	for (; i + 4 <= count; i += 4) {
+		__m128i x, y, w, h;
+		collisionLoadRects(rects + i, x, y, w, h);
+		__m128i overlapX = _mm_and_si128(_mm_cmplt_epi32(left, _mm_add_epi32(x, w)),
+																		 _mm_cmplt_epi32(x, right));
+		__m128i overlapY = _mm_and_si128(_mm_cmplt_epi32(top, _mm_add_epi32(y, h)),
+																		 _mm_cmplt_epi32(y, bottom));
+		hitCount += collisionStoreHits(_mm_and_si128(overlapX, overlapY), hits + i);
+	}
+#endif
+	for (; i < count; i++) {
+		hits[i] = rectsCollide(rect, rects[i]);
+		hitCount += hits[i];
+	}
+	return hitCount;
+}
+#endif
@@ -0,0 +1,149 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "CollisionWorld.hh"
+#include "Collision.hh"
+#include "MultiRectCollider.hh"
+
+CollisionWorld::CollisionWorld() {
+}
+
+int CollisionWorld::addBody(SDL_Rect* box) {
+	return addBody(BODY_RECT, box);
+}
+
+int CollisionWorld::addBody(MultiRectCollider* boxes) {
+	return addBody(BODY_RECTS, boxes);
+}
+
+int CollisionWorld::addBody(Circle* circle) {
+	return addBody(BODY_CIRCLE, circle);
+}
+
+int CollisionWorld::addBody(BodyType type, void* collider) {
+	Body body = {type, collider, 0, 0, 0, 0};
+	computeBox(body);
+
+	int id;
+	if (!mFreeIds.empty()) {
+		id = mFreeIds.back();
+		mFreeIds.pop_back();
+		mBodies[id] = body;
+	} else {
+		id = mBodies.size();
+		mBodies.push_back(body);
+	}
+	mOrder.push_back(id);
+	return id;
+}
+
+void CollisionWorld::removeBody(int id) {
+	if (id < 0 || id >= (int) mBodies.size() || mBodies[id].collider == NULL) {
+		return;
+	}
+	mBodies[id].collider = NULL;
+	mOrder.erase(std::find(mOrder.begin(), mOrder.end(), id));
+	mFreeIds.push_back(id);
+}
+
+void CollisionWorld::clear() {
+	mBodies.clear();
+	mFreeIds.clear();
+	mOrder.clear();
+	mPairs.clear();
+}
+
+/**
+ * Sweep and prune along x
+ * After sorting by left edge, a body can only overlap the bodies after it
+ * that start before its right edge, so the inner loop stops at the first one
+ * that starts past it
+ */
+void CollisionWorld::update() {
+	for (auto id: mOrder) {
+		computeBox(mBodies[id]);
+	}
+
+	// Insertion sort, nearly sorted from the last update
+	for (size_t i = 1; i < mOrder.size(); i++) {
+		int id = mOrder[i];
+		int minX = mBodies[id].minX;
+		size_t j = i;
+		while (j > 0 && mBodies[mOrder[j - 1]].minX > minX) {
+			mOrder[j] = mOrder[j - 1];
+			j--;
+		}
+		mOrder[j] = id;
+	}
+
+	mPairs.clear();
+	for (size_t i = 0; i < mOrder.size(); i++) {
+		Body& a = mBodies[mOrder[i]];
+		for (size_t j = i + 1; j < mOrder.size(); j++) {
+			Body& b = mBodies[mOrder[j]];
+			if (b.minX > a.maxX) {
+				break;
+			}
+			if (b.minY <= a.maxY && a.minY <= b.maxY) {
+				mPairs.emplace_back(std::min(mOrder[i], mOrder[j]), std::max(mOrder[i], mOrder[j]));
+			}
+		}
+	}
+}
+
+std::vector<std::pair<int, int>>& CollisionWorld::getPairs() {
+	return mPairs;
+}
+
+// Body queries, NULL when the body is of another type
+CollisionWorld::BodyType CollisionWorld::getType(int id) {
+	return mBodies[id].type;
+}
+
+SDL_Rect* CollisionWorld::getRect(int id) {
+	return mBodies[id].type == BODY_RECT ? static_cast<SDL_Rect*>(mBodies[id].collider) : NULL;
+}
+
+MultiRectCollider* CollisionWorld::getRects(int id) {
+	return mBodies[id].type == BODY_RECTS ? static_cast<MultiRectCollider*>(mBodies[id].collider) : NULL;
+}
+
+Circle* CollisionWorld::getCircle(int id) {
+	return mBodies[id].type == BODY_CIRCLE ? static_cast<Circle*>(mBodies[id].collider) : NULL;
+}
+
+int CollisionWorld::getBodyCount() {
+	return mOrder.size();
+}
+
+// Box the body's collider, edges included so touching bodies are candidates
+void CollisionWorld::computeBox(Body& body) {
+	switch (body.type) {
+		case BODY_RECT: {
+			SDL_Rect* box = static_cast<SDL_Rect*>(body.collider);
+			body.minX = box->x;
+			body.maxX = box->x + box->w;
+			body.minY = box->y;
+			body.maxY = box->y + box->h;
+			break;
+		}
+		case BODY_RECTS: {
+			const SDL_Rect& box = static_cast<MultiRectCollider*>(body.collider)->getBounds();
+			body.minX = box.x;
+			body.maxX = box.x + box.w;
+			body.minY = box.y;
+			body.maxY = box.y + box.h;
+			break;
+		}
+		case BODY_CIRCLE: {
+			Circle* circle = static_cast<Circle*>(body.collider);
+			body.minX = circle->x - circle->r;
+			body.maxX = circle->x + circle->r;
+			body.minY = circle->y - circle->r;
+			body.maxY = circle->y + circle->r;
+			break;
+		}
+	}
+}
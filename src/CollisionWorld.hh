@@ -0,0 +1,65 @@
+#ifndef COLLISIONWORLD
+#define COLLISIONWORLD
+
+#include <SDL2/SDL.h>
+#include <utility>
+#include <vector>
+
+#include "Collision.hh"
+#include "MultiRectCollider.hh"
+
+// Broad phase for scenes with many moving bodies
+// Bodies point at colliders owned elsewhere (a box, a Dot's list of boxes or
+// its circle), so the world always sees where they currently are. Each
+// update boxes every body, sorts the boxes along x and sweeps across them;
+// only bodies whose boxes overlap on both axes come back as candidate pairs
+// for the narrow phase checks in Collision.hh.
+//
+// Bodies barely move between frames, so the order from the last update is
+// kept and re-sorted by insertion, which is close to linear.
+class CollisionWorld {
+	public:
+		enum BodyType {
+			BODY_RECT,
+			BODY_RECTS,
+			BODY_CIRCLE
+		};
+
+		CollisionWorld();
+
+		// Register a collider, returns the body's id
+		int addBody(SDL_Rect*);
+		int addBody(MultiRectCollider*);
+		int addBody(Circle*);
+		void removeBody(int);
+		void clear();
+
+		// Find the candidate pairs for the colliders' current positions
+		// Pairs hold body ids, lowest first
+		void update();
+		std::vector<std::pair<int, int>>& getPairs();
+
+		// Body queries for the narrow phase
+		BodyType getType(int);
+		SDL_Rect* getRect(int);
+		MultiRectCollider* getRects(int);
+		Circle* getCircle(int);
+		int getBodyCount();
+
+	private:
+		struct Body {
+			BodyType type;
+			void* collider; // NULL once removed
+			int minX, maxX; // Box from the last update
+			int minY, maxY;
+		};
+
+		std::vector<Body> mBodies; // Indexed by id
+		std::vector<int> mFreeIds; // Ids of removed bodies to reuse
+		std::vector<int> mOrder; // Ids sorted by minX
+		std::vector<std::pair<int, int>> mPairs;
+
+		int addBody(BodyType, void*);
+		void computeBox(Body&);
+};
+#endif
@@ -1,21 +1,19 @@
 #include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
+#include "Collision.hh"
 #include "Dot.hh"
 #include "LTexture.hh"
+#include "MultiRectCollider.hh"
+#include "SweptCollision.hh"
 
 #define LEVEL_WIDTH (1280)
 #define LEVEL_HEIGHT (960)
 #define SCREEN_WIDTH (640)
 #define SCREEN_HEIGHT (480)
 
-// Collision Check functions for circles
-bool checkCollision(Circle&, Circle&);
-bool checkCollision(Circle&, SDL_Rect&);
-		
-// Helper function to calculate distance between points
-double distanceSquared(int, int, int, int);
-
 // Constructor
 Dot::Dot() {
 	mPosX = 0;
@@ -23,9 +21,10 @@ Dot::Dot() {
 	mVelX = 0;
 	mVelY = 0;
 
-	mColliders.resize(1);
-	mColliders[0].w = DOT_WIDTH;
-	mColliders[0].h = DOT_HEIGHT;
+	mExactX = mPrevX = 0;
+	mExactY = mPrevY = 0;
+
+	mColliders.addRect(0, 0, DOT_WIDTH, DOT_HEIGHT);
 	mCircleCollider = {0, 0, 0};
 }
 
@@ -37,45 +36,22 @@ Dot::Dot(int x, int y) {
 	mVelX = 0;
 	mVelY = 0;
 
-	mColliders.resize(11);
+	mExactX = mPrevX = x;
+	mExactY = mPrevY = y;
 
-	// Initialize collision boxes width/height
+	// Initialize collision boxes width/height, stacked from top to bottom and
+	// centered horizontally
 	// Note: this level of detail is usually excessive
 	// Does not need to be pixel perfect, could instead be rectangles that are
 	// close enough
-	mColliders[0].w = 6;
-	mColliders[0].h = 1;
-
-	mColliders[1].w = 10;
-	mColliders[1].h = 1;
-
-	mColliders[2].w = 14;
-	mColliders[2].h = 1;
-
-	mColliders[3].w = 16;
-	mColliders[3].h = 2;
-
-	mColliders[4].w = 18;
-	mColliders[4].h = 2;
-
-	mColliders[5].w = 20;
-	mColliders[5].h = 6;
+	const int widths[] = {6, 10, 14, 16, 18, 20, 18, 16, 14, 10, 6};
+	const int heights[] = {1, 1, 1, 2, 2, 6, 2, 2, 1, 1, 1};
 
-	mColliders[6].w = 18;
-	mColliders[6].h = 2;
-
-	mColliders[7].w = 16;
-	mColliders[7].h = 2;
-
-	mColliders[8].w = 14;
-	mColliders[8].h = 1;
-
-
-	mColliders[9].w = 10;
-	mColliders[9].h = 1;
-
-	mColliders[10].w = 6;
-	mColliders[10].h = 1;
+	int r = 0;
+	for (int i = 0; i < 11; i++) {
+		mColliders.addRect((DOT_WIDTH - widths[i]) / 2, r, widths[i], heights[i]);
+		r += heights[i];
+	}
 
 	mCircleCollider.r = DOT_WIDTH / 2;
 
@@ -92,7 +68,7 @@ int Dot::getPosY() {
 	return mPosY;
 }
 
-std::vector<SDL_Rect>& Dot::getColliders() {
+MultiRectCollider& Dot::getColliders() {
 	return mColliders;
 }
 
@@ -163,31 +139,30 @@ void Dot::move(bool level) {
 			mPosY -= mVelY;
 		}
 
-		mColliders[0].x = mPosX;
-		mColliders[0].y = mPosY;
+		shiftColliders();
 	}
 }
 
 // Move while checking that there is no collision with the given rectangle
 void Dot::move(SDL_Rect& wall, bool checkCollision(SDL_Rect, SDL_Rect)) {
 	mPosX += mVelX;
-	mColliders[0].x = mPosX;
+	shiftColliders();
 	// Too far, move back
-	if (mPosX < 0 || mPosX + DOT_WIDTH > SCREEN_WIDTH || checkCollision(mColliders[0], wall)) {
+	if (mPosX < 0 || mPosX + DOT_WIDTH > SCREEN_WIDTH || checkCollision(mColliders.getBounds(), wall)) {
 		mPosX -= mVelX;
-		mColliders[0].x = mPosX;
+		shiftColliders();
 	}
 
 	mPosY += mVelY;
-	mColliders[0].y = mPosY;
-	if (mPosY < 0 || mPosY + DOT_HEIGHT > SCREEN_HEIGHT || checkCollision(mColliders[0], wall)) {
+	shiftColliders();
+	if (mPosY < 0 || mPosY + DOT_HEIGHT > SCREEN_HEIGHT || checkCollision(mColliders.getBounds(), wall)) {
 		mPosY -= mVelY;
-		mColliders[0].y = mPosY;
+		shiftColliders();
 	}
 }
 
-void Dot::move(std::vector<SDL_Rect>& otherColliders,
-							 bool checkCollision(std::vector<SDL_Rect>, std::vector<SDL_Rect>)) {
+void Dot::move(const MultiRectCollider& otherColliders,
+							 bool checkCollision(const MultiRectCollider&, const MultiRectCollider&)) {
 	mPosX += mVelX;
 	shiftColliders();
 	if (mPosX < 0 || mPosX + DOT_WIDTH > SCREEN_WIDTH ||
@@ -210,14 +185,14 @@ void Dot::move(SDL_Rect& square, Circle& circle) {
 	shiftColliders();
 
 	if (mPosX - mCircleCollider.r < 0 || mPosX + mCircleCollider.r > SCREEN_WIDTH ||
-			checkCollision(mCircleCollider, square) || checkCollision(mCircleCollider, circle)) {
+			circleCollidesRect(mCircleCollider, square) || circlesCollide(mCircleCollider, circle)) {
 		mPosX -= mVelX;
 	}
 
 	mPosY += mVelY;
 	shiftColliders();
 	if (mPosY - mCircleCollider.r < 0 || mPosY + mCircleCollider.r > SCREEN_HEIGHT ||
-			checkCollision(mCircleCollider, square) || checkCollision(mCircleCollider, circle)) {
+			circleCollidesRect(mCircleCollider, square) || circlesCollide(mCircleCollider, circle)) {
 		mPosY-= mVelY;
 		shiftColliders();
 	}
@@ -250,75 +225,96 @@ void Dot::move(float timeStep) {
 	}
 }
 
+/**
+ * Sweeps the dot through the step instead of jumping to its end, so even a
+ * dot crossing a wall thinner than itself within one step stops against it
+ * On a hit, the dot moves up to the wall and the rest of the step continues
+ * along the wall's surface with the part going into it removed.
+ * The exact position carries over between moves, so steps shorter than a
+ * pixel still add up, unless another move changed the position since.
+ */
+void Dot::move(float timeStep, const std::vector<SDL_Rect>& walls) {
+	float distance = DOT_VEL_FRAME_IND * timeStep;
+	float dx = mVelX > 0 ? distance : mVelX < 0 ? -distance : 0;
+	float dy = mVelY > 0 ? distance : mVelY < 0 ? -distance : 0;
+
+	bool circular = mCircleCollider.r > 0;
+	const SDL_Rect& bounds = mColliders.getBounds();
+	if (std::lround(mExactX) != mPosX || std::lround(mExactY) != mPosY) {
+		mExactX = mPosX;
+		mExactY = mPosY;
+	}
+	mPrevX = mExactX;
+	mPrevY = mExactY;
+
+	float x = mExactX;
+	float y = mExactY;
+
+	for (int i = 0; i < MAX_SLIDES && (dx != 0 || dy != 0); i++) {
+		// Find the first wall hit
+		SweepHit first = {1, 0, 0};
+		bool hit = false;
+		for (auto & wall: walls) {
+			SweepHit current;
+			bool touched = circular ?
+				sweepCircle(x, y, mCircleCollider.r, dx, dy, wall, current) :
+				sweepRect(x + bounds.x - mPosX, y + bounds.y - mPosY, bounds.w, bounds.h,
+									dx, dy, wall, current);
+			if (touched && current.time < first.time) {
+				first = current;
+				hit = true;
+			}
+		}
+
+		x += dx * first.time;
+		y += dy * first.time;
+		if (!hit) {
+			break;
+		}
+
+		// Slide along the wall with what is left of the step
+		dx *= 1 - first.time;
+		dy *= 1 - first.time;
+		float into = dx * first.normalX + dy * first.normalY;
+		dx -= into * first.normalX;
+		dy -= into * first.normalY;
+	}
+
+	// Keep on the screen, position is the center for circles
+	float left = circular ? mCircleCollider.r : 0;
+	float top = circular ? mCircleCollider.r : 0;
+	float right = circular ? SCREEN_WIDTH - mCircleCollider.r : SCREEN_WIDTH - DOT_WIDTH;
+	float bottom = circular ? SCREEN_HEIGHT - mCircleCollider.r : SCREEN_HEIGHT - DOT_HEIGHT;
+	mExactX = std::min(std::max(x, left), right);
+	mExactY = std::min(std::max(y, top), bottom);
+
+	mPosX = std::lround(mExactX);
+	mPosY = std::lround(mExactY);
+
+	shiftColliders();
+}
+
 void Dot::render(SDL_Renderer* renderer, LTexture* texture_ptr) {
 	texture_ptr->render(renderer, mPosX - mCircleCollider.r, mPosY - mCircleCollider.r);
 }
 
+// Render between the positions before and after the last move, alpha of the
+// way from one to the other
+void Dot::render(SDL_Renderer* renderer, LTexture* texture_ptr, float alpha) {
+	float x = mPrevX + (mExactX - mPrevX) * alpha;
+	float y = mPrevY + (mExactY - mPrevY) * alpha;
+	texture_ptr->render(renderer, std::lround(x) - mCircleCollider.r,
+											std::lround(y) - mCircleCollider.r);
+}
+
 void Dot::render(SDL_Renderer* renderer, LTexture* texture_ptr, int camX, int camY) {
 	texture_ptr->render(renderer, mPosX - camX, mPosY - camY);
 }
 
 // Reset the position of each collider for the dot's new position
 void Dot::shiftColliders() {
-	int r = 0;
-
-	for (size_t i = 0; i < mColliders.size(); i++) {
-		// Set coordinates of each collider
-		mColliders[i].x = mPosX + (DOT_WIDTH - mColliders[i].w) / 2;
-		mColliders[i].y = mPosY + r;
-
-		// Update current "height" of the collider
-		r += mColliders[i].h;
-	}
+	mColliders.setPosition(mPosX, mPosY);
 
 	mCircleCollider.x = mPosX;
 	mCircleCollider.y = mPosY;
 }
-
-bool checkCollision(Circle& a, Circle& b) {
-	int rSquared = a.r + b.r;
-	rSquared *= rSquared;
-
-	// Check if circles have collided
-	if (distanceSquared(a.x, a.y, b.x, b.y) < rSquared) {
-		return true;
-	}
-
-	return false;
-}
-
-bool checkCollision(Circle& a, SDL_Rect& b) {
-	// Find closed point on the box to the circle
-	int cX;
-	int cY;
-
-	// Figure out which side of the box the circle is closest to
-	if (a.x < b.x) {
-		cX = b.x;
-	} else if (a.x > b.x + b.w) {
-		cX = b.x + b.w;
-	} else {
-		cX = a.x;
-	}
-
-	if (a.y < b.y) {
-		cY = b.y;
-	} else if (a.y > b.y + b.h) {
-		cY = b.y + b.h;
-	} else {
-		cY = a.y;
-	}
-
-	// Check if they collide
-	if (distanceSquared(a.x, a.y, cX, cY) < a.r * a.r) {
-		return true;
-	}
-
-	return false;
-}
-
-double distanceSquared(int x1, int y1, int x2, int y2) {
-	int dX = x2 - x1;
-	int dY = y2 - y1;
-	return dX * dX + dY * dY;
-}
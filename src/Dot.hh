@@ -4,13 +4,9 @@
 #include <SDL2/SDL.h>
 #include <vector>
 
+#include "Collision.hh"
 #include "LTexture.hh"
-
-typedef struct Circle {
-	int x;
-	int y;
-	int r;
-} Circle;
+#include "MultiRectCollider.hh"
 
 class Dot {
 	public:
@@ -22,6 +18,9 @@ class Dot {
 		static const int DOT_VEL = 10;
 		static const int DOT_VEL_FRAME_IND = 640;
 
+		// Times a swept move can slide along a surface it hit
+		static const int MAX_SLIDES = 3;
+
 		Dot();
 		Dot(int x, int y);
 
@@ -33,8 +32,8 @@ class Dot {
 		void move(SDL_Rect&, bool checkCollision(SDL_Rect, SDL_Rect));
 
 		// Move with pixel perfect collision
-		void move(std::vector<SDL_Rect>&,
-							bool checkCollision(std::vector<SDL_Rect>, std::vector<SDL_Rect>));
+		void move(const MultiRectCollider&,
+							bool checkCollision(const MultiRectCollider&, const MultiRectCollider&));
 		
 		// Move with circular collision
 		void move(SDL_Rect&, Circle&);
@@ -42,21 +41,31 @@ class Dot {
 		// Move dot independent of number of frames
 		void move(float timeStep);
 
+		// Move independent of number of frames, sliding along the walls
+		// Uses the circle collider if it has a radius, the boxes' bounds if not
+		void move(float timeStep, const std::vector<SDL_Rect>& walls);
+
 		void render(SDL_Renderer*, LTexture*);
+		// Render between the last two positions of a fixed step simulation
+		void render(SDL_Renderer*, LTexture*, float alpha);
 		// Render relative to a camera
 		void render(SDL_Renderer*, LTexture*, int, int);
 
 		// Getters
 		int getPosX();
 		int getPosY();
-		std::vector<SDL_Rect>& getColliders();
+		MultiRectCollider& getColliders();
 		Circle& getCircularCollider();
 
 	private:
 		// Current position and velocity
 		int mPosX, mPosY;
 		int mVelX, mVelY;
-		std::vector<SDL_Rect> mColliders; // Collision box
+		// Position between pixels kept by frame independent moves, and the one
+		// before the last move to render between them
+		float mExactX, mExactY;
+		float mPrevX, mPrevY;
+		MultiRectCollider mColliders; // Collision boxes
 		Circle mCircleCollider;
 
 		void shiftColliders();
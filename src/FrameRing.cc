@@ -0,0 +1,90 @@
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <vector>
+
+#include "FrameRing.hh"
+
+FrameRing::FrameRing() {
+	for (int i = 0; i < 3; i++) {
+		mPublishTimes[i] = 0;
+	}
+	mWriteIndex = 0;
+	mReadIndex = 1;
+	mShared = 2;
+	mPublished = 0;
+	mDropped = 0;
+	mAcquired = 0;
+	mLatency = 0;
+	mTotalLatency = 0;
+}
+
+// Must be called before either thread starts using the ring
+bool FrameRing::create(size_t frameBytes) {
+	free();
+	for (int i = 0; i < 3; i++) {
+		mBuffers[i].assign(frameBytes, 0);
+	}
+	return frameBytes > 0;
+}
+
+void FrameRing::free() {
+	for (int i = 0; i < 3; i++) {
+		mBuffers[i].clear();
+		mPublishTimes[i] = 0;
+	}
+	mWriteIndex = 0;
+	mReadIndex = 1;
+	mShared = 2;
+	mPublished = 0;
+	mDropped = 0;
+	mAcquired = 0;
+	mLatency = 0;
+	mTotalLatency = 0;
+}
+
+Uint8* FrameRing::getWriteBuffer() {
+	return mBuffers[mWriteIndex].data();
+}
+
+// The exchange releases the frame's pixels and time to the consumer
+void FrameRing::publish() {
+	mPublishTimes[mWriteIndex] = SDL_GetPerformanceCounter();
+	int previous = mShared.exchange(mWriteIndex | FRESH, std::memory_order_acq_rel);
+	if (previous & FRESH) {
+		mDropped.fetch_add(1, std::memory_order_relaxed);
+	}
+	mWriteIndex = previous & ~FRESH;
+	mPublished.fetch_add(1, std::memory_order_relaxed);
+}
+
+const Uint8* FrameRing::acquire() {
+	if (!(mShared.load(std::memory_order_relaxed) & FRESH)) {
+		return NULL;
+	}
+
+	int previous = mShared.exchange(mReadIndex, std::memory_order_acq_rel);
+	mReadIndex = previous & ~FRESH;
+
+	Uint64 elapsed = SDL_GetPerformanceCounter() - mPublishTimes[mReadIndex];
+	mLatency = elapsed * 1000.0 / SDL_GetPerformanceFrequency();
+	mTotalLatency += mLatency;
+	mAcquired++;
+	return mBuffers[mReadIndex].data();
+}
+
+// Statistics
+Uint64 FrameRing::getPublished() {
+	return mPublished.load(std::memory_order_relaxed);
+}
+
+Uint64 FrameRing::getDropped() {
+	return mDropped.load(std::memory_order_relaxed);
+}
+
+double FrameRing::getLatency() {
+	return mLatency;
+}
+
+double FrameRing::getAverageLatency() {
+	return mAcquired > 0 ? mTotalLatency / mAcquired : 0;
+}
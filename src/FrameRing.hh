@@ -0,0 +1,53 @@
+#ifndef FRAMERING
+#define FRAMERING
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <vector>
+
+// Lock free hand off of frames from one producer thread to one consumer
+// Three frame buffers rotate between the producer (filling one), the
+// consumer (reading one) and a shared slot holding the newest finished
+// frame. Publishing swaps the filled buffer into the shared slot and taking
+// a frame swaps it out again, so neither side ever waits. A frame replaced
+// in the shared slot before the consumer took it is counted as dropped.
+class FrameRing {
+	public:
+		FrameRing();
+
+		bool create(size_t); // Bytes per frame
+		void free();
+
+		// Producer side
+		Uint8* getWriteBuffer(); // Buffer to fill with the next frame
+		void publish(); // Hand the filled buffer over as the newest frame
+
+		// Consumer side
+		// Newest frame, or NULL if nothing was published since the last call
+		// The frame stays valid until the next call
+		const Uint8* acquire();
+
+		// Statistics, read on the consumer side
+		Uint64 getPublished();
+		Uint64 getDropped();
+		double getLatency(); // Milliseconds from publish to acquire, last frame
+		double getAverageLatency();
+
+	private:
+		static const int FRESH = 4; // Set on the shared slot when not yet taken
+
+		std::vector<Uint8> mBuffers[3];
+		Uint64 mPublishTimes[3]; // Written with the frame, read after taking it
+
+		int mWriteIndex; // Only touched by the producer
+		int mReadIndex; // Only touched by the consumer
+		std::atomic<int> mShared; // Buffer index, plus FRESH
+
+		std::atomic<Uint64> mPublished;
+		std::atomic<Uint64> mDropped;
+
+		Uint64 mAcquired;
+		double mLatency;
+		double mTotalLatency;
+};
+#endif
@@ -0,0 +1,155 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "LAssetLoader.hh"
+#include "LTexture.hh"
+
+LAssetLoader::LAssetLoader(int threads) {
+	mPending = 0;
+	mQuit = false;
+
+	if (threads <= 0) {
+		threads = std::max((int) std::thread::hardware_concurrency(), 1);
+	}
+	for (int i = 0; i < threads; i++) {
+		mWorkers.push_back(std::thread(&LAssetLoader::work, this));
+	}
+}
+
+// Stop the workers and drop anything that was not uploaded
+LAssetLoader::~LAssetLoader() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mQuit = true;
+	}
+	mWake.notify_all();
+	for (auto & worker: mWorkers) {
+		worker.join();
+	}
+}
+
+// The renderer is only asked for its format here, workers never touch it
+int LAssetLoader::load(std::string path, LTexture* target, SDL_Renderer* renderer,
+											 LTextureOptions options) {
+	int handle = mStates.size();
+	mStates.push_back(LOAD_QUEUED);
+	mPending++;
+
+	if (options.format == SDL_PIXELFORMAT_UNKNOWN) {
+		options.format = LTexture::getNativeFormat(renderer);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mJobs.push_back({path, target, options});
+		mQueue.push_back(handle);
+	}
+	mWake.notify_one();
+	return handle;
+}
+
+/**
+ * Create textures for up to maxUploads decoded images
+ * Returns how many loads were completed, including failed ones
+ */
+int LAssetLoader::update(SDL_Renderer* renderer, int maxUploads) {
+	int completed = 0;
+	while (completed < maxUploads) {
+		DecodedImage decoded;
+		LoadJob job;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mDecoded.empty()) {
+				break;
+			}
+			decoded = std::move(mDecoded.front());
+			job = mJobs[decoded.handle];
+			mDecoded.pop_front();
+		}
+
+		mStates[decoded.handle] = LOAD_FAILED;
+		if (!decoded.pixels.empty() &&
+				job.target->loadFromConverted(decoded.pixels.data(), decoded.width, decoded.height,
+																			renderer, job.options)) {
+			mStates[decoded.handle] = LOAD_READY;
+		}
+		mPending--;
+		completed++;
+	}
+	return completed;
+}
+
+// Upload everything as soon as it is decoded
+// Returns false if any load has failed
+bool LAssetLoader::finish(SDL_Renderer* renderer) {
+	while (mPending > 0) {
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mDecodedSignal.wait(lock, [this]() { return !mDecoded.empty(); });
+		}
+		update(renderer, mPending);
+	}
+
+	for (auto state: mStates) {
+		if (state == LOAD_FAILED) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Handle state
+bool LAssetLoader::isReady(int handle) {
+	return handle >= 0 && handle < (int) mStates.size() && mStates[handle] == LOAD_READY;
+}
+
+bool LAssetLoader::hasFailed(int handle) {
+	return handle >= 0 && handle < (int) mStates.size() && mStates[handle] == LOAD_FAILED;
+}
+
+int LAssetLoader::getPending() {
+	return mPending;
+}
+
+// Take jobs off the queue and decode them until the loader is destroyed
+void LAssetLoader::work() {
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (true) {
+		mWake.wait(lock, [this]() { return mQuit || !mQueue.empty(); });
+		if (mQuit) {
+			return;
+		}
+
+		int handle = mQueue.front();
+		mQueue.pop_front();
+		LoadJob job = mJobs[handle]; // Jobs may grow while decoding
+		lock.unlock();
+
+		DecodedImage decoded = {handle, {}, 0, 0};
+		if (!decode(job, decoded)) {
+			decoded.pixels.clear();
+		}
+
+		lock.lock();
+		mDecoded.push_back(std::move(decoded));
+		mDecodedSignal.notify_one();
+	}
+}
+
+// Decode and convert the image into the staging buffer in the job's format
+bool LAssetLoader::decode(LoadJob& job, DecodedImage& decoded) {
+	SDL_Surface* surface = LTexture::decodeImage(job.path);
+	if (surface == NULL) {
+		return false;
+	}
+
+	bool success = LTexture::convertImage(surface, decoded.pixels, job.options);
+	decoded.width = surface->w;
+	decoded.height = surface->h;
+	SDL_FreeSurface(surface);
+	return success;
+}
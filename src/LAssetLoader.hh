@@ -0,0 +1,84 @@
+#ifndef LASSETLOADER
+#define LASSETLOADER
+
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LTexture.hh"
+
+// Loads images into textures without stalling the render thread
+// Decoding, format conversion and color keying happen on a pool of worker
+// threads through the same steps as LTexture::loadFromFile, since none of
+// them needs the renderer. Workers convert straight into the texture's
+// format, picked on the render thread when the load is queued. Finished
+// pixels wait until update is called on the render thread, which uploads a
+// bounded number of them per frame so a large batch of loads does not cause
+// a long frame.
+//
+// Each load returns a handle that can be polled, so game code can keep
+// drawing placeholders until the texture it needs is ready. The loader must
+// be used and destroyed on the render thread.
+class LAssetLoader {
+	public:
+		static const int UPLOADS_PER_FRAME = 8;
+
+		LAssetLoader(int = 0); // Worker threads, 0 for one per core
+		~LAssetLoader();
+
+		// Queue image at path to be loaded into the given texture with the given
+		// options. The texture must stay alive until the load is done.
+		int load(std::string, LTexture*, SDL_Renderer*, LTextureOptions = LTextureOptions());
+
+		int update(SDL_Renderer*, int = UPLOADS_PER_FRAME); // Upload finished images
+		bool finish(SDL_Renderer*); // Block until everything queued is loaded
+
+		// Handle state
+		bool isReady(int);
+		bool hasFailed(int);
+
+		int getPending(); // Loads not yet uploaded
+
+	private:
+		enum LoadState {
+			LOAD_QUEUED,
+			LOAD_READY,
+			LOAD_FAILED
+		};
+
+		struct LoadJob {
+			std::string path;
+			LTexture* target;
+			LTextureOptions options; // Format already resolved
+		};
+
+		// Staging buffer of converted pixels, empty when loading failed
+		struct DecodedImage {
+			int handle;
+			std::vector<Uint32> pixels;
+			int width, height;
+		};
+
+		// Only touched by the render thread
+		std::vector<LoadState> mStates;
+		int mPending;
+
+		// Shared with the workers, guarded by mMutex
+		std::mutex mMutex;
+		std::condition_variable mWake; // Signals workers about new jobs
+		std::condition_variable mDecodedSignal; // Signals finish about decoded images
+		std::vector<LoadJob> mJobs;
+		std::deque<int> mQueue;
+		std::deque<DecodedImage> mDecoded;
+		bool mQuit;
+
+		std::vector<std::thread> mWorkers;
+
+		void work(); // Worker thread body
+		bool decode(LoadJob&, DecodedImage&);
+};
+#endif
@@ -0,0 +1,252 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include "LAtlas.hh"
+#include "LTexture.hh"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iostream>
+
+LSprite::LSprite() {
+	mPage = NULL;
+	mClip = {0, 0, 0, 0};
+}
+
+// Render the sprite's portion of the shared page
+void LSprite::render(SDL_Renderer* renderer, int x, int y, double angle,
+										 SDL_Point* center, SDL_RendererFlip flip) {
+	if (mPage != NULL) {
+		mPage->render(renderer, x, y, &mClip, angle, center, flip);
+	}
+}
+
+// Getters
+int LSprite::getWidth() {
+	return mClip.w;
+}
+
+int LSprite::getHeight() {
+	return mClip.h;
+}
+
+LTexture* LSprite::getPage() {
+	return mPage;
+}
+
+SDL_Rect* LSprite::getClip() {
+	return &mClip;
+}
+
+LAtlas::LAtlas(int pageWidth, int pageHeight) {
+	mPageWidth = pageWidth;
+	mPageHeight = pageHeight;
+}
+
+LAtlas::~LAtlas() {
+	free();
+}
+
+/**
+ * Decode the image and keep it until pack is called
+ * The color key is applied now so the blit onto the page leaves keyed pixels
+ * transparent
+ */
+int LAtlas::addFromFile(std::string path, Uint8 keyR, Uint8 keyG, Uint8 keyB) {
+	SDL_Surface* loadedSurface = IMG_Load(path.c_str());
+	if (loadedSurface == NULL) {
+		std::cout << "Image load error (Path: " << path << "): " << IMG_GetError() << '\n';
+		return -1;
+	}
+
+	SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, keyR, keyG, keyB));
+	// Copy pixels as they are instead of blending with the empty page
+	SDL_SetSurfaceBlendMode(loadedSurface, SDL_BLENDMODE_NONE);
+
+	mSprites.push_back(LSprite());
+	mPending.push_back({loadedSurface, (int) mSprites.size() - 1});
+	return mSprites.size() - 1;
+}
+
+/**
+ * Place every queued image on a page, starting new pages as the current one
+ * fills up. Images are placed tallest first which keeps the skyline flat.
+ * Images larger than a page get a page of their own.
+ */
+bool LAtlas::pack(SDL_Renderer* renderer) {
+	std::sort(mPending.begin(), mPending.end(),
+						[](const PendingImage& a, const PendingImage& b) {
+							if (a.surface->h != b.surface->h) {
+								return a.surface->h > b.surface->h;
+							}
+							return a.surface->w > b.surface->w;
+						});
+
+	bool success = true;
+	while (success && !mPending.empty()) {
+		int w = mPending[0].surface->w + PADDING;
+		int h = mPending[0].surface->h + PADDING;
+
+		if (w > mPageWidth || h > mPageHeight) {
+			std::vector<PendingImage> single(1, mPending[0]);
+			mPending.erase(mPending.begin());
+			success = packPage(renderer, single, std::max(w, mPageWidth), std::max(h, mPageHeight));
+			mPending.insert(mPending.end(), single.begin(), single.end());
+		} else {
+			success = packPage(renderer, mPending, mPageWidth, mPageHeight);
+		}
+	}
+
+	// Anything left over could not be packed
+	for (auto & image: mPending) {
+		SDL_FreeSurface(image.surface);
+	}
+	mPending.clear();
+
+	return success;
+}
+
+void LAtlas::free() {
+	for (auto page: mPages) {
+		delete page;
+	}
+	mPages.clear();
+
+	for (auto & image: mPending) {
+		SDL_FreeSurface(image.surface);
+	}
+	mPending.clear();
+	mSprites.clear();
+}
+
+// Getters
+LSprite* LAtlas::getSprite(int id) {
+	if (id < 0 || id >= (int) mSprites.size()) {
+		return NULL;
+	}
+	return &mSprites[id];
+}
+
+int LAtlas::getSpriteCount() {
+	return mSprites.size();
+}
+
+int LAtlas::getPageCount() {
+	return mPages.size();
+}
+
+/**
+ * Find the lowest spot on the skyline that fits a w by h rectangle
+ * Ties are broken by using the narrowest segment to leave wide gaps open
+ */
+bool LAtlas::findPosition(SkylinePage& page, int w, int h, int* bestX, int* bestY,
+													size_t* bestIndex) {
+	int bestTop = page.h + 1;
+	int bestWidth = page.w + 1;
+	bool found = false;
+
+	for (size_t i = 0; i < page.nodes.size(); i++) {
+		int x = page.nodes[i].x;
+		if (x + w > page.w) {
+			break;
+		}
+
+		// Rest on the highest segment the rectangle spans
+		int y = 0;
+		int widthLeft = w;
+		for (size_t j = i; widthLeft > 0 && j < page.nodes.size(); j++) {
+			y = std::max(y, page.nodes[j].y);
+			widthLeft -= page.nodes[j].w;
+		}
+		if (y + h > page.h) {
+			continue;
+		}
+
+		if (y + h < bestTop || (y + h == bestTop && page.nodes[i].w < bestWidth)) {
+			bestTop = y + h;
+			bestWidth = page.nodes[i].w;
+			*bestX = x;
+			*bestY = y;
+			*bestIndex = i;
+			found = true;
+		}
+	}
+	return found;
+}
+
+// Raise the skyline over a newly placed rectangle
+void LAtlas::addSkylineLevel(SkylinePage& page, size_t index, int x, int y, int w, int h) {
+	page.nodes.insert(page.nodes.begin() + index, {x, y + h, w});
+
+	// Shrink or remove the segments now covered by the new one
+	for (size_t i = index + 1; i < page.nodes.size();) {
+		SkylineNode& prev = page.nodes[i - 1];
+		int overlap = prev.x + prev.w - page.nodes[i].x;
+		if (overlap <= 0) {
+			break;
+		}
+
+		page.nodes[i].x += overlap;
+		page.nodes[i].w -= overlap;
+		if (page.nodes[i].w > 0) {
+			break;
+		}
+		page.nodes.erase(page.nodes.begin() + i);
+	}
+
+	// Merge neighbours at the same height
+	for (size_t i = 0; i + 1 < page.nodes.size();) {
+		if (page.nodes[i].y == page.nodes[i + 1].y) {
+			page.nodes[i].w += page.nodes[i + 1].w;
+			page.nodes.erase(page.nodes.begin() + i + 1);
+		} else {
+			i++;
+		}
+	}
+}
+
+/**
+ * Fill one page with as many of the given images as fit
+ * Placed images are removed from the list and their surfaces freed
+ */
+bool LAtlas::packPage(SDL_Renderer* renderer, std::vector<PendingImage>& images,
+											int pageWidth, int pageHeight) {
+	// Pixels start out fully transparent
+	SDL_Surface* pageSurface = SDL_CreateRGBSurfaceWithFormat(0, pageWidth, pageHeight, 32,
+																														SDL_PIXELFORMAT_RGBA8888);
+	if (pageSurface == NULL) {
+		std::cout << "Unable to create atlas page: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	LTexture* pageTexture = new LTexture();
+	SkylinePage page = {pageWidth, pageHeight, {{0, 0, pageWidth}}};
+	std::vector<PendingImage> leftover;
+
+	for (auto & image: images) {
+		int x, y;
+		size_t index;
+		int w = image.surface->w;
+		int h = image.surface->h;
+
+		if (!findPosition(page, w + PADDING, h + PADDING, &x, &y, &index)) {
+			leftover.push_back(image);
+			continue;
+		}
+		addSkylineLevel(page, index, x, y, w + PADDING, h + PADDING);
+
+		SDL_Rect dest = {x, y, w, h};
+		SDL_BlitSurface(image.surface, NULL, pageSurface, &dest);
+		SDL_FreeSurface(image.surface);
+
+		mSprites[image.sprite].mPage = pageTexture;
+		mSprites[image.sprite].mClip = {x, y, w, h};
+	}
+	images.swap(leftover);
+
+	bool success = pageTexture->loadFromSurface(pageSurface, renderer);
+	SDL_FreeSurface(pageSurface);
+	mPages.push_back(pageTexture);
+	return success;
+}
@@ -0,0 +1,84 @@
+#ifndef LATLAS
+#define LATLAS
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+#include "LTexture.hh"
+
+// Handle to one image packed into an atlas page
+// Renders as a clip of the shared page texture so many sprites can be drawn
+// without switching textures
+class LSprite {
+	public:
+		LSprite();
+
+		// Render at given point
+		void render(SDL_Renderer*, int, int, double = 0, SDL_Point* = NULL,
+								SDL_RendererFlip = SDL_FLIP_NONE);
+
+		// Getters
+		int getWidth();
+		int getHeight();
+		LTexture* getPage();
+		SDL_Rect* getClip();
+
+	private:
+		friend class LAtlas;
+
+		LTexture* mPage; // Shared page, owned by the atlas
+		SDL_Rect mClip; // Location of the image on the page
+};
+
+// Packs many images into one or a few large textures at load time
+class LAtlas {
+	public:
+		// Padding between packed images so linear filtering does not bleed
+		static const int PADDING = 1;
+
+		LAtlas(int = 1024, int = 1024); // Page dimensions
+		~LAtlas();
+
+		// Queue image to be packed, color keyed like LTexture::loadFromFile
+		// Returns the id of the sprite or -1 on failure
+		int addFromFile(std::string, Uint8 = 0, Uint8 = 0xff, Uint8 = 0xff);
+
+		bool pack(SDL_Renderer*); // Pack queued images into pages
+
+		void free(); // Deallocate pages and queued images
+
+		// Getters
+		LSprite* getSprite(int);
+		int getSpriteCount();
+		int getPageCount();
+
+	private:
+		// Segment of the skyline, the top edge of the used space on a page
+		struct SkylineNode {
+			int x, y, w;
+		};
+
+		struct SkylinePage {
+			int w, h;
+			std::vector<SkylineNode> nodes;
+		};
+
+		struct PendingImage {
+			SDL_Surface* surface;
+			int sprite;
+		};
+
+		int mPageWidth;
+		int mPageHeight;
+
+		std::vector<LTexture*> mPages;
+		std::vector<LSprite> mSprites;
+		std::vector<PendingImage> mPending;
+
+		bool findPosition(SkylinePage&, int, int, int*, int*, size_t*);
+		void addSkylineLevel(SkylinePage&, size_t, int, int, int, int);
+		bool packPage(SDL_Renderer*, std::vector<PendingImage>&, int, int);
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include <SDL2/SDL.h>
+
+#include "LFrameLimiter.hh"
+
+// Constructor
+LFrameLimiter::LFrameLimiter(int fps) {
+	mFrameLength = SDL_GetPerformanceFrequency() / (fps > 0 ? fps : 60);
+	mDeadline = 0;
+	mMissed = 0;
+}
+
+void LFrameLimiter::wait() {
+	Uint64 now = SDL_GetPerformanceCounter();
+	if (mDeadline == 0) {
+		mDeadline = now;
+	}
+	mDeadline += mFrameLength;
+
+	if (now >= mDeadline) {
+		mMissed++;
+		if (now - mDeadline > mFrameLength) {
+			mDeadline = now;
+		}
+		return;
+	}
+
+	// Sleep off all but the last stretch
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	Uint64 spin = SPIN_MICROSECONDS * frequency / 1000000;
+	if (mDeadline - now > spin) {
+		SDL_Delay((mDeadline - now - spin) * 1000 / frequency);
+	}
+
+	while (SDL_GetPerformanceCounter() < mDeadline) {
+	}
+}
+
+void LFrameLimiter::reset() {
+	mDeadline = 0;
+}
+
+// Getters
+Uint64 LFrameLimiter::getMissed() {
+	return mMissed;
+}
@@ -0,0 +1,29 @@
+#ifndef LFRAMELIMITER
+#define LFRAMELIMITER
+
+#include <SDL2/SDL.h>
+
+// Holds a loop to a frame rate by waiting for each frame's deadline
+// SDL_Delay only sleeps whole milliseconds and often wakes late, so it is
+// only used until SPIN_MICROSECONDS before the deadline; the rest is spent
+// polling the performance counter. Deadlines follow on from each other rather
+// than from when the wait ended, so the rate holds on average too. A frame
+// that overruns its deadline is counted as missed, and after one overruns by
+// more than a whole frame the deadlines restart from then.
+class LFrameLimiter {
+	public:
+		static const int SPIN_MICROSECONDS = 2000;
+
+		LFrameLimiter(int fps);
+
+		void wait(); // Call once per frame, returns at the frame's deadline
+		void reset(); // Restart the deadlines from now
+
+		Uint64 getMissed();
+
+	private:
+		Uint64 mFrameLength; // Counter units per frame
+		Uint64 mDeadline; // 0 until the first wait
+		Uint64 mMissed;
+};
+#endif
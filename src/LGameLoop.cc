@@ -0,0 +1,59 @@
+#include <SDL2/SDL.h>
+
+#include "LGameLoop.hh"
+#include "LPerfTimer.hh"
+
+// Constructor
+LGameLoop::LGameLoop(int tickRate) {
+	if (tickRate <= 0) {
+		tickRate = DEFAULT_TICK_RATE;
+	}
+	mTickRate = tickRate;
+	mTickLength = 1000000000 / tickRate;
+	mAccumulator = 0;
+	mTickCount = 0;
+	mStarted = false;
+}
+
+// Start from scratch, the first tick runs a whole tick later
+void LGameLoop::start() {
+	mFrameTimer.start();
+	mFrameTimer.resetLaps();
+	mAccumulator = 0;
+	mTickCount = 0;
+	mStarted = true;
+}
+
+int LGameLoop::advance() {
+	if (!mStarted) {
+		start();
+	}
+
+	mAccumulator += mFrameTimer.lap();
+
+	int ticks = mAccumulator / mTickLength;
+	mAccumulator -= ticks * mTickLength;
+	if (ticks > MAX_TICKS_PER_FRAME) {
+		ticks = MAX_TICKS_PER_FRAME;
+	}
+
+	mTickCount += ticks;
+	return ticks;
+}
+
+// Getters
+float LGameLoop::getTickTime() {
+	return 1.f / mTickRate;
+}
+
+float LGameLoop::getAlpha() {
+	return (float) mAccumulator / mTickLength;
+}
+
+Uint64 LGameLoop::getTickCount() {
+	return mTickCount;
+}
+
+LPerfTimer& LGameLoop::getFrameTimer() {
+	return mFrameTimer;
+}
@@ -0,0 +1,42 @@
+#ifndef LGAMELOOP
+#define LGAMELOOP
+
+#include <SDL2/SDL.h>
+
+#include "LPerfTimer.hh"
+
+// Drives a simulation at a fixed tick rate while rendering every frame
+// Each frame, advance adds the time since the last frame to an accumulator
+// and returns how many whole ticks fit in it; the caller runs that many
+// simulation steps of getTickTime seconds. What is left over, as a fraction
+// of a tick, is the alpha to render between the last two simulated states.
+// Frames are timed as laps of an LPerfTimer and the accumulator counts whole
+// nanoseconds, so it never drifts and every run with the same frame times
+// simulates the same steps.
+class LGameLoop {
+	public:
+		static const int DEFAULT_TICK_RATE = 30; // Ticks per second
+
+		// Most ticks to run in one frame, time beyond that (after a stall) is
+		// dropped instead of falling further behind
+		static const int MAX_TICKS_PER_FRAME = 8;
+
+		LGameLoop(int tickRate = DEFAULT_TICK_RATE);
+
+		void start();
+		int advance(); // Call once per frame, returns ticks to simulate
+
+		float getTickTime(); // Seconds per tick
+		float getAlpha(); // Progress towards the next tick, 0 to 1
+		Uint64 getTickCount(); // Ticks simulated since start
+		LPerfTimer& getFrameTimer(); // Each frame is a lap
+
+	private:
+		int mTickRate;
+		Uint64 mTickLength; // Nanoseconds per tick
+		Uint64 mAccumulator;
+		LPerfTimer mFrameTimer;
+		Uint64 mTickCount;
+		bool mStarted;
+};
+#endif
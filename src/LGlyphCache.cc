@@ -0,0 +1,154 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include "LGlyphCache.hh"
+#include "LTexture.hh"
+
+LGlyphCache::LGlyphCache() {
+	mFont = NULL;
+	mHeight = 0;
+	for (int i = 0; i <= LAST_GLYPH; i++) {
+		mGlyphs[i] = {0, 0, 0, 0};
+		mAdvance[i] = 0;
+	}
+}
+
+LGlyphCache::~LGlyphCache() {
+	free();
+}
+
+/**
+ * Render every glyph once and pack them row by row into one texture
+ * Each glyph surface starts at the font's ascent with the glyph already placed
+ * on the baseline, so glyphs only need to be lined up horizontally when drawn.
+ * Glyphs reaching below the font's descent come back taller than the font,
+ * so each row is as tall as its tallest glyph.
+ */
+bool LGlyphCache::build(TTF_Font* font, SDL_Renderer* renderer) {
+	free();
+
+	SDL_Color white = {0xff, 0xff, 0xff, 0xff};
+	SDL_Surface* glyphSurfaces[LAST_GLYPH + 1] = {NULL};
+
+	mHeight = TTF_FontHeight(font);
+	int x = 0;
+	int y = 0;
+	int rowHeight = 0;
+	bool success = true;
+	for (int c = FIRST_GLYPH; c <= LAST_GLYPH && success; c++) {
+		glyphSurfaces[c] = TTF_RenderGlyph_Blended(font, c, white);
+		if (glyphSurfaces[c] == NULL) {
+			std::cout << "Glyph render error: " << TTF_GetError() << '\n';
+			success = false;
+			break;
+		}
+		TTF_GlyphMetrics(font, c, NULL, NULL, NULL, NULL, &mAdvance[c]);
+
+		// Start a new row when out of space
+		int w = glyphSurfaces[c]->w;
+		int h = glyphSurfaces[c]->h;
+		if (x + w > ATLAS_WIDTH) {
+			x = 0;
+			y += rowHeight + 1;
+			rowHeight = 0;
+		}
+		mGlyphs[c] = {x, y, w, h};
+		x += w + 1;
+		rowHeight = std::max(rowHeight, h);
+	}
+
+	SDL_Surface* atlas = NULL;
+	if (success) {
+		atlas = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, y + rowHeight, 32,
+																					 SDL_PIXELFORMAT_RGBA8888);
+		if (atlas == NULL) {
+			std::cout << "Unable to create glyph atlas: " << SDL_GetError() << '\n';
+			success = false;
+		}
+	}
+
+	for (int c = FIRST_GLYPH; c <= LAST_GLYPH; c++) {
+		if (glyphSurfaces[c] != NULL) {
+			if (atlas != NULL) {
+				// Copy alpha as it is instead of blending with the empty atlas
+				SDL_SetSurfaceBlendMode(glyphSurfaces[c], SDL_BLENDMODE_NONE);
+				SDL_BlitSurface(glyphSurfaces[c], NULL, atlas, &mGlyphs[c]);
+			}
+			SDL_FreeSurface(glyphSurfaces[c]);
+		}
+	}
+
+	if (atlas != NULL) {
+		success = mGlyphTexture.loadFromSurface(atlas, renderer);
+		SDL_FreeSurface(atlas);
+	}
+
+	if (!success) {
+		free();
+		return false;
+	}
+	mFont = font;
+	return true;
+}
+
+void LGlyphCache::free() {
+	mGlyphTexture.free();
+	mFont = NULL;
+	mHeight = 0;
+}
+
+// Queue a quad per glyph and submit them all at once
+void LGlyphCache::renderText(SDL_Renderer* renderer, int x, int y, std::string text,
+														 SDL_Color color) {
+	if (mFont == NULL) {
+		return;
+	}
+
+	int curX = x;
+	Uint16 previous = 0;
+	for (size_t i = 0; i < text.length(); i++) {
+		Uint16 glyph = glyphFor(text[i]);
+		if (previous != 0) {
+			curX += TTF_GetFontKerningSizeGlyphs(mFont, previous, glyph);
+		}
+
+		mBatch.draw(renderer, &mGlyphTexture, curX, y, &mGlyphs[glyph], color);
+		curX += mAdvance[glyph];
+		previous = glyph;
+	}
+	mBatch.flush(renderer);
+}
+
+// Same walk as renderText without drawing
+int LGlyphCache::getTextWidth(std::string text) {
+	if (mFont == NULL) {
+		return 0;
+	}
+
+	int width = 0;
+	Uint16 previous = 0;
+	for (size_t i = 0; i < text.length(); i++) {
+		Uint16 glyph = glyphFor(text[i]);
+		if (previous != 0) {
+			width += TTF_GetFontKerningSizeGlyphs(mFont, previous, glyph);
+		}
+		width += mAdvance[glyph];
+		previous = glyph;
+	}
+	return width;
+}
+
+int LGlyphCache::getHeight() {
+	return mHeight;
+}
+
+Uint16 LGlyphCache::glyphFor(char c) {
+	unsigned char ascii = c;
+	if (ascii < FIRST_GLYPH || ascii > LAST_GLYPH) {
+		return '?';
+	}
+	return ascii;
+}
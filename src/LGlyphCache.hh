@@ -0,0 +1,45 @@
+#ifndef LGLYPHCACHE
+#define LGLYPHCACHE
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+
+#include "LTexture.hh"
+#include "LSpriteBatch.hh"
+
+// Printable ASCII glyphs of a font rasterized once into a single texture
+// Strings are drawn as batched glyph quads with kerning, so text that changes
+// every frame costs no rasterization or texture creation. Glyphs are stored
+// in white and tinted when drawn, so one cache serves every color.
+class LGlyphCache {
+	public:
+		static const int FIRST_GLYPH = ' ';
+		static const int LAST_GLYPH = '~';
+		static const int ATLAS_WIDTH = 512; // Glyph rows wrap at this width
+
+		LGlyphCache();
+		~LGlyphCache();
+
+		bool build(TTF_Font*, SDL_Renderer*); // Rasterize all glyphs of font
+		void free();
+
+		// Render string with top left at given point
+		void renderText(SDL_Renderer*, int, int, std::string, SDL_Color = {0, 0, 0, 0xff});
+
+		// Dimension getters
+		int getTextWidth(std::string);
+		int getHeight();
+
+	private:
+		TTF_Font* mFont; // Used for kerning lookups
+		LTexture mGlyphTexture;
+		LSpriteBatch mBatch;
+
+		SDL_Rect mGlyphs[LAST_GLYPH + 1]; // Location of each glyph in texture
+		int mAdvance[LAST_GLYPH + 1]; // Horizontal distance to the next glyph
+		int mHeight;
+
+		Uint16 glyphFor(char); // Substitute characters not in the cache
+};
+#endif
@@ -0,0 +1,156 @@
+#include <SDL2/SDL.h>
+#include <cmath>
+
+#include "LPerfTimer.hh"
+
+// Constructor
+LPerfTimer::LPerfTimer() {
+	mStartCounter = 0;
+	mPauseCounter = 0;
+	mLapStart = 0;
+
+	mPaused = false;
+	mStarted = false;
+
+	resetLaps();
+}
+
+// Start the timer (unpaused, from scratch), the first lap starts with it
+void LPerfTimer::start() {
+	mStarted = true;
+	mPaused = false;
+
+	mStartCounter = SDL_GetPerformanceCounter();
+	mPauseCounter = 0;
+	mLapStart = 0;
+}
+
+// Stop timer, reset variables
+void LPerfTimer::stop() {
+	mStarted = false;
+	mPaused = false;
+
+	mStartCounter = 0;
+	mPauseCounter = 0;
+	mLapStart = 0;
+}
+
+// Pause timer
+void LPerfTimer::pause() {
+	if (mStarted && !mPaused) {
+		mPaused = true;
+
+		mPauseCounter = SDL_GetPerformanceCounter() - mStartCounter;
+		mStartCounter = 0;
+	}
+}
+
+// Unpause a paused timer
+void LPerfTimer::unpause() {
+	if (mStarted && mPaused) {
+		mPaused = false;
+
+		mStartCounter = SDL_GetPerformanceCounter() - mPauseCounter;
+		mPauseCounter = 0;
+	}
+}
+
+Uint64 LPerfTimer::getNanoseconds() {
+	return toNanoseconds(getElapsed());
+}
+
+double LPerfTimer::getMilliseconds() {
+	return getElapsed() * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+/**
+ * Records the finished lap's length
+ * Mean and deviation are kept with Welford's running update, so no lap
+ * lengths need to be stored however many laps are timed
+ */
+Uint64 LPerfTimer::lap() {
+	if (!mStarted) {
+		return 0;
+	}
+
+	Uint64 elapsed = getElapsed();
+	Uint64 length = toNanoseconds(elapsed - mLapStart);
+	mLapStart = elapsed;
+
+	mLapCount++;
+	mLastLap = length;
+	if (mLapCount == 1 || length < mMinLap) {
+		mMinLap = length;
+	}
+	if (length > mMaxLap) {
+		mMaxLap = length;
+	}
+	double difference = length - mLapMean;
+	mLapMean += difference / mLapCount;
+	mLapSquares += difference * (length - mLapMean);
+
+	return length;
+}
+
+Uint64 LPerfTimer::split() {
+	return mStarted ? toNanoseconds(getElapsed() - mLapStart) : 0;
+}
+
+// Getters
+bool LPerfTimer::isStarted() {
+	return mStarted;
+}
+
+bool LPerfTimer::isPaused() {
+	return mPaused && mStarted;
+}
+
+Uint64 LPerfTimer::getLapCount() {
+	return mLapCount;
+}
+
+Uint64 LPerfTimer::getLastLap() {
+	return mLastLap;
+}
+
+Uint64 LPerfTimer::getMinLap() {
+	return mMinLap;
+}
+
+Uint64 LPerfTimer::getMaxLap() {
+	return mMaxLap;
+}
+
+double LPerfTimer::getAverageLap() {
+	return mLapMean;
+}
+
+double LPerfTimer::getLapDeviation() {
+	return mLapCount > 1 ? std::sqrt(mLapSquares / (mLapCount - 1)) : 0;
+}
+
+void LPerfTimer::resetLaps() {
+	mLapCount = 0;
+	mLastLap = 0;
+	mMinLap = 0;
+	mMaxLap = 0;
+	mLapMean = 0;
+	mLapSquares = 0;
+}
+
+Uint64 LPerfTimer::getElapsed() {
+	if (mStarted) {
+		if (mPaused) {
+			return mPauseCounter;
+		} else {
+			return SDL_GetPerformanceCounter() - mStartCounter;
+		}
+	}
+	return 0;
+}
+
+// Split into whole seconds and the rest so the multiply cannot overflow
+Uint64 LPerfTimer::toNanoseconds(Uint64 counter) {
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	return counter / frequency * 1000000000 + counter % frequency * 1000000000 / frequency;
+}
@@ -0,0 +1,54 @@
+#ifndef LPERFTIMER
+#define LPERFTIMER
+
+#include <SDL2/SDL.h>
+
+// Timer like LTimer, counting nanoseconds off the performance counter
+// instead of milliseconds from SDL_GetTicks, which is too coarse to time a
+// frame. Besides the total, it times laps: each lap ends where the next
+// begins, and the lengths of finished laps are kept as statistics. Time
+// spent paused counts towards neither.
+class LPerfTimer {
+	public:
+		LPerfTimer();
+		void start();
+		void stop();
+		void pause();
+		void unpause();
+		Uint64 getNanoseconds(); // Elapsed since start
+		double getMilliseconds();
+		bool isStarted();
+		bool isPaused();
+
+		Uint64 lap(); // End the current lap, returns its length in nanoseconds
+		Uint64 split(); // Time into the current lap so far
+
+		// Lap statistics, in nanoseconds
+		Uint64 getLapCount();
+		Uint64 getLastLap();
+		Uint64 getMinLap();
+		Uint64 getMaxLap();
+		double getAverageLap();
+		double getLapDeviation(); // Standard deviation
+		void resetLaps();
+
+	private:
+		Uint64 mStartCounter; // Counter when started, adjusted for pauses
+		Uint64 mPauseCounter; // Counter units elapsed when paused
+		Uint64 mLapStart; // Counter units elapsed when the lap began
+
+		// Timer status
+		bool mPaused;
+		bool mStarted;
+
+		Uint64 mLapCount;
+		Uint64 mLastLap;
+		Uint64 mMinLap;
+		Uint64 mMaxLap;
+		double mLapMean; // Running mean and sum of squared differences
+		double mLapSquares;
+
+		Uint64 getElapsed(); // In counter units
+		static Uint64 toNanoseconds(Uint64);
+};
+#endif
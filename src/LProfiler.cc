@@ -0,0 +1,284 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "LProfiler.hh"
+#include "LGlyphCache.hh"
+
+static std::string escapeJson(const char*);
+
+// Constructor
+LProfiler::LProfiler() {
+	mEvents = std::vector<Event>(EVENT_CAPACITY);
+	for (auto & event: mEvents) {
+		event.sequence.store(0, std::memory_order_relaxed);
+	}
+	mWriteIndex = 0;
+	mReadIndex = 0;
+
+	mOrigin = SDL_GetPerformanceCounter();
+	mFrameStart = mOrigin;
+	mFrames = {"Frame", std::vector<double>(FRAME_HISTORY, 0), 0, 0};
+	mHistoryIndex = 0;
+}
+
+void LProfiler::beginFrame() {
+	mFrameStart = SDL_GetPerformanceCounter();
+}
+
+/**
+ * Adds the frame's events to their zones and moves on to the next history
+ * entry
+ * Events claimed but still being written by another thread are left out.
+ * The next frame starts here unless beginFrame is called.
+ */
+void LProfiler::endFrame() {
+	Uint64 frameEnd = SDL_GetPerformanceCounter();
+	record(mFrames.name, mFrameStart, frameEnd);
+	mFrames.current = toMilliseconds(frameEnd - mFrameStart);
+
+	Uint64 written = mWriteIndex.load(std::memory_order_acquire);
+	if (written - mReadIndex > EVENT_CAPACITY) {
+		mReadIndex = written - EVENT_CAPACITY;
+	}
+	for (; mReadIndex < written; mReadIndex++) {
+		EventCopy event;
+		if (!readEvent(mReadIndex, event) || event.name == mFrames.name) {
+			continue;
+		}
+
+		auto zone = std::find_if(mZones.begin(), mZones.end(), [&](Zone& z) {
+			return std::strcmp(z.name, event.name) == 0;
+		});
+		if (zone == mZones.end()) {
+			mZones.push_back({event.name, std::vector<double>(FRAME_HISTORY, 0), 0, 0});
+			zone = mZones.end() - 1;
+		}
+		zone->current += toMilliseconds(event.end - event.start);
+	}
+
+	mFrames.times[mHistoryIndex] = mFrames.current;
+	mFrames.filled = std::min(mFrames.filled + 1, FRAME_HISTORY);
+	for (auto & zone: mZones) {
+		zone.times[mHistoryIndex] = zone.current;
+		zone.current = 0;
+		zone.filled = std::min(zone.filled + 1, FRAME_HISTORY);
+	}
+	mHistoryIndex = (mHistoryIndex + 1) % FRAME_HISTORY;
+
+	mFrameStart = frameEnd;
+}
+
+// Claims the next slot, overwriting the oldest event once the ring is full
+void LProfiler::record(const char* name, Uint64 start, Uint64 end) {
+	Uint64 index = mWriteIndex.fetch_add(1, std::memory_order_relaxed);
+	Event& event = mEvents[index & (EVENT_CAPACITY - 1)];
+
+	event.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	event.name.store(name, std::memory_order_relaxed);
+	event.start.store(start, std::memory_order_relaxed);
+	event.end.store(end, std::memory_order_relaxed);
+	event.thread.store(SDL_ThreadID(), std::memory_order_relaxed);
+	event.sequence.store(index + 1, std::memory_order_release);
+}
+
+// Copies the event at index, false if it was not written yet or overwritten
+bool LProfiler::readEvent(Uint64 index, EventCopy& copy) {
+	Event& event = mEvents[index & (EVENT_CAPACITY - 1)];
+	if (event.sequence.load(std::memory_order_acquire) != index + 1) {
+		return false;
+	}
+
+	copy.name = event.name.load(std::memory_order_relaxed);
+	copy.start = event.start.load(std::memory_order_relaxed);
+	copy.end = event.end.load(std::memory_order_relaxed);
+	copy.thread = event.thread.load(std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return event.sequence.load(std::memory_order_relaxed) == index + 1;
+}
+
+// Frame statistics
+double LProfiler::getMinFrame() {
+	return getMin(mFrames);
+}
+
+double LProfiler::getAverageFrame() {
+	return getAverage(mFrames);
+}
+
+double LProfiler::getFramePercentile(double percent) {
+	return getPercentile(mFrames, percent);
+}
+
+/**
+ * Draws a line of statistics for the whole frame and each zone, with the
+ * frame times below as one column per frame, oldest on the left
+ * The line across the graph marks a 60 fps frame.
+ */
+void LProfiler::renderOverlay(SDL_Renderer* renderer, LGlyphCache* glyphs, int x, int y) {
+	std::vector<std::string> lines;
+	std::stringstream line;
+	line << "ms: min / avg / p99";
+	lines.push_back(line.str());
+
+	std::vector<Zone*> zones = {&mFrames};
+	for (auto & zone: mZones) {
+		zones.push_back(&zone);
+	}
+	for (auto zone: zones) {
+		line.str("");
+		line << std::fixed << std::setprecision(2) << zone->name << " " << getMin(*zone) <<
+			" / " << getAverage(*zone) << " / " << getPercentile(*zone, 99);
+		lines.push_back(line.str());
+	}
+
+	int lineHeight = glyphs->getHeight();
+	int width = FRAME_HISTORY;
+	for (auto & text: lines) {
+		width = std::max(width, glyphs->getTextWidth(text));
+	}
+	int graphBottom = y + lines.size() * lineHeight + GRAPH_HEIGHT;
+
+	// Translucent background
+	SDL_Rect background = {x, y, width, graphBottom - y};
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0xc0);
+	SDL_RenderFillRect(renderer, &background);
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+	SDL_Color textColor = {0xff, 0xff, 0xff, 0xff};
+	for (size_t i = 0; i < lines.size(); i++) {
+		glyphs->renderText(renderer, x, y + i * lineHeight, lines[i], textColor);
+	}
+
+	SDL_SetRenderDrawColor(renderer, 0x40, 0xff, 0x40, 0xff);
+	std::vector<double> frameTimes = getHistory(mFrames);
+	for (int i = 0; i < (int) frameTimes.size(); i++) {
+		int barHeight = std::min(frameTimes[i] / GRAPH_MAX_MS, 1.0) * GRAPH_HEIGHT;
+		if (barHeight > 0) {
+			SDL_RenderDrawLine(renderer, x + i, graphBottom - 1, x + i, graphBottom - barHeight);
+		}
+	}
+
+	int target = graphBottom - 1000.0 / 60 / GRAPH_MAX_MS * GRAPH_HEIGHT;
+	SDL_SetRenderDrawColor(renderer, 0xff, 0x40, 0x40, 0xff);
+	SDL_RenderDrawLine(renderer, x, target, x + FRAME_HISTORY - 1, target);
+}
+
+/**
+ * Writes every event still in the ring as a complete ("X") trace event
+ * Times are in microseconds from when the profiler was created, and each
+ * thread gets its own track.
+ */
+bool LProfiler::writeTrace(std::string path) {
+	std::stringstream json;
+	json << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+
+	Uint64 written = mWriteIndex.load(std::memory_order_acquire);
+	Uint64 first = written > EVENT_CAPACITY ? written - EVENT_CAPACITY : 0;
+	bool separate = false;
+	for (Uint64 i = first; i < written; i++) {
+		EventCopy event;
+		if (!readEvent(i, event)) {
+			continue;
+		}
+		if (separate) {
+			json << ",";
+		}
+		separate = true;
+
+		json << "\n{\"name\":\"" << escapeJson(event.name) << "\",\"ph\":\"X\",\"pid\":1," <<
+			"\"tid\":" << event.thread << ",\"ts\":" << toMilliseconds(event.start - mOrigin) * 1000 <<
+			",\"dur\":" << toMilliseconds(event.end - event.start) * 1000 << "}";
+	}
+	json << "\n]}\n";
+
+	SDL_RWops* file = SDL_RWFromFile(path.c_str(), "w");
+	if (file == NULL) {
+		std::cout << "Unable to open " << path << ": " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	std::string text = json.str();
+	bool success = SDL_RWwrite(file, text.data(), 1, text.size()) == text.size();
+	if (!success) {
+		std::cout << "Unable to write " << path << ": " << SDL_GetError() << '\n';
+	}
+	SDL_RWclose(file);
+	return success;
+}
+
+// The entries a zone has filled, which end just before the next entry
+std::vector<double> LProfiler::getHistory(Zone& zone) {
+	std::vector<double> times(zone.filled);
+	for (int i = 0; i < zone.filled; i++) {
+		times[i] = zone.times[(mHistoryIndex - zone.filled + i + FRAME_HISTORY) % FRAME_HISTORY];
+	}
+	return times;
+}
+
+// Statistics over the filled part of a zone's history
+double LProfiler::getPercentile(Zone& zone, double percent) {
+	std::vector<double> times = getHistory(zone);
+	if (times.empty()) {
+		return 0;
+	}
+
+	int count = times.size();
+	int rank = std::ceil(percent / 100 * count) - 1;
+	rank = std::min(std::max(rank, 0), count - 1);
+	std::nth_element(times.begin(), times.begin() + rank, times.end());
+	return times[rank];
+}
+
+double LProfiler::getMin(Zone& zone) {
+	std::vector<double> times = getHistory(zone);
+	if (times.empty()) {
+		return 0;
+	}
+	return *std::min_element(times.begin(), times.end());
+}
+
+double LProfiler::getAverage(Zone& zone) {
+	std::vector<double> times = getHistory(zone);
+	double total = 0;
+	for (double time: times) {
+		total += time;
+	}
+	return !times.empty() ? total / times.size() : 0;
+}
+
+double LProfiler::toMilliseconds(Uint64 counter) {
+	return counter * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+// Zone timer
+LProfileZone::LProfileZone(LProfiler* profiler, const char* name) {
+	mProfiler = profiler;
+	mName = name;
+	mStart = SDL_GetPerformanceCounter();
+}
+
+LProfileZone::~LProfileZone() {
+	mProfiler->record(mName, mStart, SDL_GetPerformanceCounter());
+}
+
+// Quote and backslash are the only characters a zone name should need escaped
+static std::string escapeJson(const char* text) {
+	std::string escaped;
+	for (; *text != '\0'; text++) {
+		if (*text == '"' || *text == '\\') {
+			escaped += '\\';
+		}
+		escaped += *text;
+	}
+	return escaped;
+}
@@ -0,0 +1,101 @@
+#ifndef LPROFILER
+#define LPROFILER
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "LGlyphCache.hh"
+
+// Records how long named zones of each frame take
+// Zones are timed with LProfileZone and go into a fixed ring of events that
+// any thread can write without locking; once the ring is full the oldest
+// events are overwritten. Each endFrame adds up the frame's events by zone,
+// keeping the totals of the last FRAME_HISTORY frames for the overlay. The
+// events still in the ring can be written out as Chrome trace event JSON,
+// for chrome://tracing or Perfetto.
+//
+// Zone names are not copied, so they should be string literals.
+class LProfiler {
+	public:
+		static constexpr int EVENT_CAPACITY = 8192; // Power of two
+		static constexpr int FRAME_HISTORY = 240;
+		static constexpr int GRAPH_HEIGHT = 60;
+		static constexpr double GRAPH_MAX_MS = 33.3; // Frame time at the top of the graph
+
+		LProfiler();
+
+		void beginFrame();
+		void endFrame();
+
+		// Record a finished zone, from performance counter values
+		void record(const char*, Uint64, Uint64);
+
+		// Statistics of frames in the history, in milliseconds
+		double getMinFrame();
+		double getAverageFrame();
+		double getFramePercentile(double);
+
+		// Draw the statistics and a graph of frame times, with top left at x, y
+		void renderOverlay(SDL_Renderer*, LGlyphCache*, int, int);
+
+		bool writeTrace(std::string);
+
+	private:
+		// Fields are written in between two sequence stores, a reader only
+		// trusts them if it sees the same finished sequence before and after
+		struct Event {
+			std::atomic<Uint64> sequence; // Index + 1 once written, 0 while writing
+			std::atomic<const char*> name;
+			std::atomic<Uint64> start;
+			std::atomic<Uint64> end;
+			std::atomic<Uint64> thread;
+		};
+
+		struct EventCopy {
+			const char* name;
+			Uint64 start;
+			Uint64 end;
+			Uint64 thread;
+		};
+
+		// Totals of a zone over the history, in milliseconds
+		// Zones first seen after the history started only count their own frames
+		struct Zone {
+			const char* name;
+			std::vector<double> times;
+			double current;
+			int filled; // Entries before the next history entry that are the zone's
+		};
+
+		std::vector<Event> mEvents;
+		std::atomic<Uint64> mWriteIndex;
+		Uint64 mReadIndex; // Events before this were added to the zones
+
+		Uint64 mOrigin; // Counter at creation, traces start from here
+		Uint64 mFrameStart;
+		Zone mFrames; // Whole frames
+		std::vector<Zone> mZones;
+		int mHistoryIndex; // Next history entry to fill
+
+		bool readEvent(Uint64, EventCopy&);
+		std::vector<double> getHistory(Zone&); // Filled entries, oldest first
+		double getPercentile(Zone&, double);
+		double getMin(Zone&);
+		double getAverage(Zone&);
+		double toMilliseconds(Uint64);
+};
+
+// Times from construction to destruction as a zone named name
+class LProfileZone {
+	public:
+		LProfileZone(LProfiler*, const char* name);
+		~LProfileZone();
+
+	private:
+		LProfiler* mProfiler;
+		const char* mName;
+		Uint64 mStart;
+};
+#endif
@@ -0,0 +1,110 @@
+#include <SDL2/SDL.h>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+#include "LSpriteBatch.hh"
+#include "LTexture.hh"
+#include "LAtlas.hh"
+
+LSpriteBatch::LSpriteBatch() {
+	mTexture = NULL;
+	mTextureWidth = 0;
+	mTextureHeight = 0;
+}
+
+/**
+ * Add one quad to the batch, starting a new run if the texture changes
+ * Rotation and flipping follow SDL_RenderCopyEx: rotate clockwise in degrees
+ * around center (middle of the quad by default)
+ */
+void LSpriteBatch::draw(SDL_Renderer* renderer, LTexture* texture, int x, int y,
+												SDL_Rect* clip, SDL_Color color, double angle, SDL_Point* center,
+												SDL_RendererFlip flip) {
+	SDL_Texture* sdlTexture = texture->getTexture();
+	if (sdlTexture == NULL) {
+		return;
+	}
+
+	if (sdlTexture != mTexture) {
+		flush(renderer);
+		mTexture = sdlTexture;
+		mTextureWidth = texture->getWidth();
+		mTextureHeight = texture->getHeight();
+	}
+
+	// Geometry ignores texture modulation, so it is folded into vertex colors
+	// Read on every draw, since it may change between quads of one run
+	SDL_Color modulation;
+	SDL_GetTextureColorMod(sdlTexture, &modulation.r, &modulation.g, &modulation.b);
+	SDL_GetTextureAlphaMod(sdlTexture, &modulation.a);
+
+	SDL_Rect source = {0, 0, texture->getWidth(), texture->getHeight()};
+	if (clip != NULL) {
+		source = *clip;
+	}
+	float w = source.w;
+	float h = source.h;
+
+	// Corners clockwise from the top left
+	SDL_FPoint corners[4] = {{0, 0}, {w, 0}, {w, h}, {0, h}};
+	if (angle != 0) {
+		float centerX = center != NULL ? center->x : w / 2;
+		float centerY = center != NULL ? center->y : h / 2;
+		float radians = angle * M_PI / 180;
+		float cosA = std::cos(radians);
+		float sinA = std::sin(radians);
+		for (auto & corner: corners) {
+			float dX = corner.x - centerX;
+			float dY = corner.y - centerY;
+			corner.x = centerX + dX * cosA - dY * sinA;
+			corner.y = centerY + dX * sinA + dY * cosA;
+		}
+	}
+
+	float u0 = source.x / mTextureWidth;
+	float u1 = (source.x + source.w) / mTextureWidth;
+	float v0 = source.y / mTextureHeight;
+	float v1 = (source.y + source.h) / mTextureHeight;
+	if (flip & SDL_FLIP_HORIZONTAL) {
+		std::swap(u0, u1);
+	}
+	if (flip & SDL_FLIP_VERTICAL) {
+		std::swap(v0, v1);
+	}
+	SDL_FPoint texCoords[4] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+
+	SDL_Color vertexColor = {(Uint8) (color.r * modulation.r / 0xff),
+													 (Uint8) (color.g * modulation.g / 0xff),
+													 (Uint8) (color.b * modulation.b / 0xff),
+													 (Uint8) (color.a * modulation.a / 0xff)};
+
+	int base = mVertices.size();
+	for (int i = 0; i < 4; i++) {
+		mVertices.push_back({{x + corners[i].x, y + corners[i].y}, vertexColor, texCoords[i]});
+	}
+
+	// Two triangles per quad
+	int quad[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+	mIndices.insert(mIndices.end(), quad, quad + 6);
+}
+
+void LSpriteBatch::draw(SDL_Renderer* renderer, LSprite* sprite, int x, int y, SDL_Color color) {
+	if (sprite->getPage() != NULL) {
+		draw(renderer, sprite->getPage(), x, y, sprite->getClip(), color);
+	}
+}
+
+// Draw everything queued so far in one call and start over
+void LSpriteBatch::flush(SDL_Renderer* renderer) {
+	if (!mIndices.empty()) {
+		if (SDL_RenderGeometry(renderer, mTexture, mVertices.data(), mVertices.size(),
+													 mIndices.data(), mIndices.size()) != 0) {
+			std::cout << "Unable to render sprite batch: " << SDL_GetError() << '\n';
+		}
+	}
+
+	mVertices.clear();
+	mIndices.clear();
+	mTexture = NULL;
+}
@@ -0,0 +1,41 @@
+#ifndef LSPRITEBATCH
+#define LSPRITEBATCH
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+#include "LTexture.hh"
+#include "LAtlas.hh"
+
+// Collects textured quads and draws each run of quads sharing a texture with
+// a single SDL_RenderGeometry call instead of one SDL_RenderCopyEx per quad
+//
+// Quads are drawn in the order they are added. The batch is flushed whenever
+// the texture changes and must be flushed at the end of the frame. Each quad
+// takes the texture's color and alpha modulation at the time it is queued.
+class LSpriteBatch {
+	public:
+		LSpriteBatch();
+
+		// Queue a quad at given point, arguments match LTexture::render plus a
+		// color and alpha that are multiplied with the texture's modulation
+		void draw(SDL_Renderer*, LTexture*, int, int, SDL_Rect* = NULL,
+							SDL_Color = {0xff, 0xff, 0xff, 0xff}, double = 0, SDL_Point* = NULL,
+							SDL_RendererFlip = SDL_FLIP_NONE);
+
+		// Queue an atlas sprite at given point
+		void draw(SDL_Renderer*, LSprite*, int, int, SDL_Color = {0xff, 0xff, 0xff, 0xff});
+
+		void flush(SDL_Renderer*); // Submit queued quads
+
+	private:
+		SDL_Texture* mTexture; // Texture of the queued quads
+		float mTextureWidth;
+		float mTextureHeight;
+
+		// Kept between frames so drawing does not allocate
+		std::vector<SDL_Vertex> mVertices;
+		std::vector<int> mIndices;
+};
+
+#endif
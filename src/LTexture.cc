@@ -3,14 +3,28 @@
 #include <SDL2/SDL_ttf.h>
 
 #include "LTexture.hh"
+#include "LZCompress.hh"
+#include "PixelOps.hh"
 
+#include <algorithm>
 #include <string>
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 LTexture::LTexture() {
 	mTexture = NULL;
 	mSurfacePixels = NULL;
+	mRawPixels = NULL;
+	mRawPitch = 0;
 	mWidth = -1;
 	mHeight = -1;
 }
@@ -19,37 +33,236 @@ LTexture::~LTexture() {
 	free();
 }
 
+// Whether packPixel can write format: 32 bits, 8 per channel, with alpha
+static bool isPackedAlpha32(Uint32 format) {
+	return SDL_ISPIXELFORMAT_PACKED(format) && SDL_ISPIXELFORMAT_ALPHA(format) &&
+		SDL_BITSPERPIXEL(format) == 32 && SDL_PIXELLAYOUT(format) == SDL_PACKEDLAYOUT_8888;
+}
+
 /**
- * Load image from specified path into this texture wrapper object
- * Set the appropriate attributes including color keying and height/width of
- * image
+ * Pick the format images are converted to for a renderer
+ * The renderer's formats are listed best first, so the first 32 bit format
+ * with 8 bits per channel and alpha is what it can upload without converting
  */
-bool LTexture::loadFromFile(std::string path, SDL_Renderer* renderer) {
-	free(); // Remove previous texture (only one at a time)
+Uint32 LTexture::getNativeFormat(SDL_Renderer* renderer) {
+	SDL_RendererInfo info;
+	if (SDL_GetRendererInfo(renderer, &info) == 0) {
+		for (Uint32 i = 0; i < info.num_texture_formats; i++) {
+			Uint32 format = info.texture_formats[i];
+			if (isPackedAlpha32(format)) {
+				return format;
+			}
+		}
+	}
+	return SDL_PIXELFORMAT_ARGB8888;
+}
 
-	SDL_Texture* newTexture = NULL;
+// Format details for converting into format, or NULL when convertPixels
+// cannot write it
+static SDL_PixelFormat* allocTargetFormat(Uint32 format) {
+	if (!isPackedAlpha32(format)) {
+		std::cout << "Texture format must be 32 bit with alpha: " <<
+			SDL_GetPixelFormatName(format) << '\n';
+		return NULL;
+	}
+	SDL_PixelFormat* targetFormat = SDL_AllocFormat(format);
+	if (targetFormat == NULL) {
+		std::cout << "Unsupported texture format: " << SDL_GetError() << '\n';
+	}
+	return targetFormat;
+}
 
+// Build one target pixel, applying the color key and premultiplied alpha
+static inline Uint32 packPixel(Uint8 r, Uint8 g, Uint8 b, Uint8 a, bool keyed,
+															 SDL_PixelFormat* format, bool premultiply) {
+	if (keyed) {
+		a = 0;
+	}
+	if (premultiply) {
+		r = r * a / 0xff;
+		g = g * a / 0xff;
+		b = b * a / 0xff;
+	}
+	return (r << format->Rshift) | (g << format->Gshift) | (b << format->Bshift) |
+		(a << format->Ashift);
+}
+
+/**
+ * Convert a decoded surface into target pixels in one pass
+ * Format conversion, color keying and premultiplying are done together as
+ * each pixel is written. Paletted images are converted through a table built
+ * from the palette, so each pixel costs a single lookup.
+ */
+static void convertPixels(SDL_Surface* surface, void* target, int targetPitch,
+													SDL_PixelFormat* format, LTextureOptions& options) {
+	SDL_PixelFormat* source = surface->format;
+	int bytes = source->BytesPerPixel;
+	Uint32 keyPixel = SDL_MapRGB(source, options.key.r, options.key.g, options.key.b);
+	Uint32 colorMask = source->Rmask | source->Gmask | source->Bmask;
+
+	Uint32 palette[256];
+	if (source->palette != NULL) {
+		for (int i = 0; i < source->palette->ncolors && i < 256; i++) {
+			SDL_Color color = source->palette->colors[i];
+			palette[i] = packPixel(color.r, color.g, color.b, 0xff,
+														 options.colorKey && (Uint32) i == keyPixel, format, options.premultiply);
+		}
+	}
+
+	for (int y = 0; y < surface->h; y++) {
+		Uint8* sourceRow = (Uint8*) surface->pixels + y * surface->pitch;
+		Uint32* targetRow = (Uint32*) ((Uint8*) target + y * targetPitch);
+
+		if (source->palette != NULL) {
+			for (int x = 0; x < surface->w; x++) {
+				targetRow[x] = palette[sourceRow[x]];
+			}
+			continue;
+		}
+
+		for (int x = 0; x < surface->w; x++) {
+			Uint8* p = sourceRow + x * bytes;
+			Uint32 pixel;
+			switch (bytes) {
+				case 2:
+					pixel = *(Uint16*) p;
+					break;
+				case 3:
+					if (SDL_BYTEORDER == SDL_LIL_ENDIAN) {
+						pixel = p[0] | (p[1] << 8) | (p[2] << 16);
+					} else {
+						pixel = (p[0] << 16) | (p[1] << 8) | p[2];
+					}
+					break;
+				default:
+					pixel = *(Uint32*) p;
+					break;
+			}
+
+			Uint8 r = ((pixel & source->Rmask) >> source->Rshift) << source->Rloss;
+			Uint8 g = ((pixel & source->Gmask) >> source->Gshift) << source->Gloss;
+			Uint8 b = ((pixel & source->Bmask) >> source->Bshift) << source->Bloss;
+			Uint8 a = 0xff;
+			if (source->Amask != 0) {
+				a = ((pixel & source->Amask) >> source->Ashift) << source->Aloss;
+			}
+			bool keyed = options.colorKey && (pixel & colorMask) == (keyPixel & colorMask);
+			targetRow[x] = packPixel(r, g, b, a, keyed, format, options.premultiply);
+		}
+	}
+}
+
+// Decode an image, widening formats with less than a byte per pixel since
+// convertPixels reads whole bytes
+SDL_Surface* LTexture::decodeImage(std::string path) {
 	SDL_Surface* loadedSurface = IMG_Load(path.c_str());
 	if (loadedSurface == NULL) {
 		std::cout << "Image load error (Path: " << path << "): " << SDL_GetError() << '\n';
+		return NULL;
+	}
+
+	if (loadedSurface->format->BitsPerPixel < 8) {
+		SDL_Surface* converted = SDL_ConvertSurfaceFormat(loadedSurface, SDL_PIXELFORMAT_ARGB8888, 0);
+		SDL_FreeSurface(loadedSurface);
+		if (converted == NULL) {
+			std::cout << "Image conversion error (Path: " << path << "): " << SDL_GetError() << '\n';
+		}
+		loadedSurface = converted;
+	}
+	return loadedSurface;
+}
+
+/**
+ * Convert a decoded image into pixels of options.format, rows packed at the
+ * image's width. Touches no renderer, so it can run on any thread.
+ */
+bool LTexture::convertImage(SDL_Surface* surface, std::vector<Uint32>& pixels,
+														LTextureOptions options) {
+	SDL_PixelFormat* targetFormat = allocTargetFormat(options.format);
+	if (targetFormat == NULL) {
 		return false;
 	}
 
-	// Color key image
-	// SetColorKey(surface, bool enable color key, pixel to color with)
-	// Original tutorials maps cyan with max blue and green
-	Uint32 color = SDL_MapRGB(loadedSurface->format, 0, 0xff, 0xff);
-	if (path.compare("images/dot.bmp") == 0) {
-		// Adjusted to be white for dot
-		color = SDL_MapRGB(loadedSurface->format, 0xff, 0xff, 0xff);
+	pixels.resize((size_t) surface->w * surface->h);
+	SDL_LockSurface(surface);
+	convertPixels(surface, pixels.data(), surface->w * 4, targetFormat, options);
+	SDL_UnlockSurface(surface);
+	SDL_FreeFormat(targetFormat);
+	return true;
+}
+
+// Premultiplied color is already scaled by alpha, so the source is added as is
+static SDL_BlendMode getBlendMode(bool premultiplied) {
+	if (premultiplied) {
+		return SDL_ComposeCustomBlendMode(
+				SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+				SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
 	}
-	SDL_SetColorKey(loadedSurface, SDL_TRUE, color);
+	return SDL_BLENDMODE_BLEND;
+}
 
-	newTexture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
+/**
+ * Load image from specified path into this texture wrapper object
+ * The decoded image is converted straight into the texture's format (the
+ * renderer's own unless the options give one), with the color key turned
+ * into transparent pixels on the way
+ */
+bool LTexture::loadFromFile(std::string path, SDL_Renderer* renderer, LTextureOptions options) {
+	free(); // Remove previous texture (only one at a time)
+
+	SDL_Surface* loadedSurface = decodeImage(path);
+	if (loadedSurface == NULL) {
+		return false;
+	}
+
+	if (options.format == SDL_PIXELFORMAT_UNKNOWN) {
+		options.format = getNativeFormat(renderer);
+	}
+
+	if (options.access != SDL_TEXTUREACCESS_STREAMING) {
+		std::vector<Uint32> pixels;
+		bool success = convertImage(loadedSurface, pixels, options) &&
+			loadFromConverted(pixels.data(), loadedSurface->w, loadedSurface->h, renderer, options);
+		SDL_FreeSurface(loadedSurface);
+		return success;
+	}
+
+	SDL_PixelFormat* targetFormat = allocTargetFormat(options.format);
+	if (targetFormat == NULL) {
+		SDL_FreeSurface(loadedSurface);
+		return false;
+	}
+
+	SDL_Texture* newTexture = SDL_CreateTexture(renderer, options.format, options.access,
+																							loadedSurface->w, loadedSurface->h);
 	if (newTexture == NULL) {
 		std::cout << "Texture conversion error: " << SDL_GetError() << '\n';
+		SDL_FreeFormat(targetFormat);
+		SDL_FreeSurface(loadedSurface);
+		return false;
+	}
+
+	// Convert straight into the texture's memory
+	void* pixels;
+	int pitch;
+	bool success = SDL_LockTexture(newTexture, NULL, &pixels, &pitch) == 0;
+	if (success) {
+		SDL_LockSurface(loadedSurface);
+		convertPixels(loadedSurface, pixels, pitch, targetFormat, options);
+		SDL_UnlockSurface(loadedSurface);
+		SDL_UnlockTexture(newTexture);
+	}
+	SDL_FreeFormat(targetFormat);
+
+	if (!success) {
+		std::cout << "Unable to fill texture (Path: " << path << "): " << SDL_GetError() << '\n';
+		SDL_DestroyTexture(newTexture);
+		SDL_FreeSurface(loadedSurface);
 		return false;
 	}
+
+	SDL_SetTextureBlendMode(newTexture, getBlendMode(options.premultiply));
+
 	// Get image dimensions from the surface
 	mWidth = loadedSurface->w;
 	mHeight = loadedSurface->h;
@@ -59,6 +272,177 @@ bool LTexture::loadFromFile(std::string path, SDL_Renderer* renderer) {
 	return true;
 }
 
+/**
+ * Create a texture from pixels made by convertImage with the same options
+ * Only the upload happens here, so this is all the render thread has to do
+ * for images converted elsewhere
+ */
+bool LTexture::loadFromConverted(const void* pixels, int width, int height,
+																 SDL_Renderer* renderer, LTextureOptions options) {
+	free();
+
+	SDL_Texture* newTexture = SDL_CreateTexture(renderer, options.format, options.access,
+																							width, height);
+	if (newTexture == NULL) {
+		std::cout << "Texture conversion error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	if (SDL_UpdateTexture(newTexture, NULL, pixels, width * 4) != 0) {
+		std::cout << "Unable to fill texture: " << SDL_GetError() << '\n';
+		SDL_DestroyTexture(newTexture);
+		return false;
+	}
+	SDL_SetTextureBlendMode(newTexture, getBlendMode(options.premultiply));
+
+	mWidth = width;
+	mHeight = height;
+	mTexture = newTexture;
+	return true;
+}
+
+/**
+ * Decode and convert an image once and save the result as a baked image
+ * Loading it later skips decoding and conversion entirely. Baked images are
+ * RGBA8888 unless the options give another 32 bit format.
+ */
+bool LTexture::bakeImage(std::string path, std::string bakedPath, LTextureOptions options,
+												 bool compress) {
+	SDL_Surface* loadedSurface = decodeImage(path);
+	if (loadedSurface == NULL) {
+		return false;
+	}
+
+	if (options.format == SDL_PIXELFORMAT_UNKNOWN) {
+		options.format = SDL_PIXELFORMAT_RGBA8888;
+	}
+
+	int width = loadedSurface->w;
+	int height = loadedSurface->h;
+	std::vector<Uint32> pixels;
+	bool converted = convertImage(loadedSurface, pixels, options);
+	SDL_FreeSurface(loadedSurface);
+	if (!converted) {
+		return false;
+	}
+
+	const Uint8* data = reinterpret_cast<const Uint8*>(pixels.data());
+	size_t dataSize = pixels.size() * 4;
+	std::vector<Uint8> compressed;
+	if (compress) {
+		lzCompress(data, dataSize, compressed);
+		data = compressed.data();
+		dataSize = compressed.size();
+	}
+
+	std::ofstream file(bakedPath, std::ios::binary | std::ios::trunc);
+	if (file.fail()) {
+		std::cout << "Unable to create file (" << bakedPath << ")\n";
+		return false;
+	}
+
+	BakedImageHeader header = {{'L', 'I', 'M', 'G'}, BAKED_VERSION,
+														 (Uint16) ((compress ? BAKED_COMPRESSED : 0) |
+																			 (options.premultiply ? BAKED_PREMULTIPLIED : 0)),
+														 options.format, (Uint32) width, (Uint32) height, (Uint32) dataSize};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(data), dataSize);
+	if (file.fail()) {
+		std::cout << "Unable to write baked image (" << bakedPath << ")\n";
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Load an image made by bakeImage
+ * The file is memory mapped and raw pixels go straight from the mapping to
+ * SDL_UpdateTexture. Compressed pixels are expanded into the locked texture
+ * when its rows are not padded, and into a staging buffer otherwise.
+ */
+bool LTexture::loadFromBaked(std::string path, SDL_Renderer* renderer) {
+	free();
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		std::cout << "Unable to open baked image (" << path << "): " << strerror(errno) << '\n';
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(BakedImageHeader)) {
+		std::cout << "Baked image too small to be valid (" << path << ")\n";
+		close(fd);
+		return false;
+	}
+
+	void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // Mapping stays valid after the descriptor is closed
+	if (mapping == MAP_FAILED) {
+		std::cout << "Unable to map file (" << path << "): " << strerror(errno) << '\n';
+		return false;
+	}
+
+	BakedImageHeader header;
+	memcpy(&header, mapping, sizeof(header));
+	const Uint8* data = static_cast<const Uint8*>(mapping) + sizeof(header);
+	size_t pixelBytes = (size_t) header.width * header.height * 4;
+	bool compressed = header.flags & BAKED_COMPRESSED;
+
+	if (memcmp(header.magic, "LIMG", 4) != 0 || header.version != BAKED_VERSION ||
+			SDL_BITSPERPIXEL(header.format) != 32 ||
+			header.dataSize > info.st_size - sizeof(header) ||
+			(!compressed && header.dataSize != pixelBytes)) {
+		std::cout << "Not a supported baked image (" << path << ")\n";
+		munmap(mapping, info.st_size);
+		return false;
+	}
+
+	SDL_Texture* newTexture = SDL_CreateTexture(renderer, header.format,
+																							compressed ? SDL_TEXTUREACCESS_STREAMING
+																												 : SDL_TEXTUREACCESS_STATIC,
+																							header.width, header.height);
+	if (newTexture == NULL) {
+		std::cout << "Unable to create texture from baked image: " << SDL_GetError() << '\n';
+		munmap(mapping, info.st_size);
+		return false;
+	}
+
+	bool success;
+	if (!compressed) {
+		success = SDL_UpdateTexture(newTexture, NULL, data, header.width * 4) == 0;
+	} else {
+		void* pixels;
+		int pitch;
+		success = SDL_LockTexture(newTexture, NULL, &pixels, &pitch) == 0;
+		if (success && pitch == (int) header.width * 4) {
+			success = lzDecompress(data, header.dataSize, static_cast<Uint8*>(pixels), pixelBytes);
+			SDL_UnlockTexture(newTexture);
+		} else if (success) {
+			std::vector<Uint8> staging(pixelBytes);
+			success = lzDecompress(data, header.dataSize, staging.data(), pixelBytes);
+			for (Uint32 row = 0; success && row < header.height; row++) {
+				memcpy(static_cast<Uint8*>(pixels) + row * pitch,
+							 staging.data() + row * header.width * 4, header.width * 4);
+			}
+			SDL_UnlockTexture(newTexture);
+		}
+	}
+	munmap(mapping, info.st_size);
+
+	if (!success) {
+		std::cout << "Unable to fill texture from baked image (" << path << ")\n";
+		SDL_DestroyTexture(newTexture);
+		return false;
+	}
+
+	SDL_SetTextureBlendMode(newTexture, getBlendMode(header.flags & BAKED_PREMULTIPLIED));
+	mTexture = newTexture;
+	mWidth = header.width;
+	mHeight = header.height;
+	return true;
+}
+
 bool LTexture::loadFromFile(std::string path, SDL_Renderer* renderer,
 														SDL_Window* window) {
 	if (!loadPixelsFromFile(path, window)) {
@@ -113,6 +497,22 @@ bool LTexture::loadFromPixels(SDL_Renderer* renderer) {
 
 	return true;
 }
+
+// Create a texture from an already decoded surface
+// The surface still belongs to the caller and must be freed by them
+bool LTexture::loadFromSurface(SDL_Surface* surface, SDL_Renderer* renderer) {
+	free();
+
+	mTexture = SDL_CreateTextureFromSurface(renderer, surface);
+	if (mTexture == NULL) {
+		std::cout << "Unable to create texture from surface: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	mWidth = surface->w;
+	mHeight = surface->h;
+	return true;
+}
 	
 /**
  * Create a texture based on TTF using the passed in text, color, and font
@@ -175,6 +575,8 @@ void LTexture::free() {
 	if (mTexture != NULL) {
 		SDL_DestroyTexture(mTexture);
 		mTexture = NULL;
+		mRawPixels = NULL;
+		mRawPitch = 0;
 		mWidth = -1;
 		mHeight = -1;
 	}
@@ -183,6 +585,8 @@ void LTexture::free() {
 		SDL_FreeSurface(mSurfacePixels);
 		mSurfacePixels = NULL;
 	}
+
+	mDirtyRects.clear();
 }
 
 /**
@@ -236,6 +640,10 @@ int LTexture::getHeight() {
 	return mHeight;
 }
 
+SDL_Texture* LTexture::getTexture() {
+	return mTexture;
+}
+
 // Pixel info getters
 
 // Getting these allows us to alter an image's pixels before loading it in
@@ -247,17 +655,36 @@ Uint32* LTexture::getPixels32() {
 	return pixels;
 }
 
-void LTexture::copyRawPixels32(void* pixels) {
-	if (mRawPixels != NULL) {
-		memcpy(mRawPixels, pixels, mRawPitch * mHeight);
+void LTexture::copyRawPixels32(const void* pixels) {
+	copyRawPixels32(pixels, mWidth * 4);
+}
+
+/**
+ * Copy a frame into the locked texture
+ * When both pitches match the frame is copied in one go, otherwise row by
+ * row so padding on either side is skipped
+ */
+void LTexture::copyRawPixels32(const void* pixels, int pitch) {
+	if (mRawPixels == NULL) {
+		return;
+	}
+
+	if (pitch == mRawPitch) {
+		memcpy(mRawPixels, pixels, (size_t) mRawPitch * mHeight);
+		return;
+	}
+
+	for (int row = 0; row < mHeight; row++) {
+		memcpy(static_cast<Uint8*>(mRawPixels) + row * mRawPitch,
+					 static_cast<const Uint8*>(pixels) + row * pitch, mWidth * 4);
 	}
 }
 
 // If pixels exists, do a conversion since they are stored in one dimension
-// to get the desired pixel
+// to get the desired pixel. Points outside the image give 0.
 Uint32 LTexture::getPixel32(Uint32 x, Uint32 y) {
 	Uint32* pixels = getPixels32();
-	if (pixels != NULL) {
+	if (pixels != NULL && x < (Uint32) mWidth && y < (Uint32) mHeight) {
 		return pixels[y * getPitch32() + x];
 	} else {
 		return 0;
@@ -273,6 +700,140 @@ Uint32 LTexture::getPitch32() {
 	return pitch;
 }
 
+// Pixel operations, run over whole rows including any padding
+bool LTexture::replacePixels(Uint32 key, Uint32 replacement) {
+	if (mSurfacePixels == NULL) {
+		return false;
+	}
+	pixelReplaceKey(getPixels32(), getPitch32() * mHeight, key, replacement);
+	return true;
+}
+
+bool LTexture::tintPixels(Uint8 red, Uint8 green, Uint8 blue) {
+	if (mSurfacePixels == NULL) {
+		return false;
+	}
+	pixelTint(getPixels32(), getPitch32() * mHeight, mSurfacePixels->format, red, green, blue);
+	return true;
+}
+
+bool LTexture::multiplyPixelAlpha(Uint8 alpha) {
+	if (mSurfacePixels == NULL) {
+		return false;
+	}
+	pixelMultiplyAlpha(getPixels32(), getPitch32() * mHeight, mSurfacePixels->format, alpha);
+	return true;
+}
+
+bool LTexture::premultiplyPixels() {
+	if (mSurfacePixels == NULL) {
+		return false;
+	}
+	pixelPremultiply(getPixels32(), getPitch32() * mHeight, mSurfacePixels->format);
+	return true;
+}
+
+bool LTexture::grayscalePixels() {
+	if (mSurfacePixels == NULL) {
+		return false;
+	}
+	pixelGrayscale(getPixels32(), getPitch32() * mHeight, mSurfacePixels->format);
+	return true;
+}
+
+/**
+ * Copy another texture's loaded pixels onto these at given point, leaving
+ * pixels where the source matches key. Both must use the same pixel format.
+ * The source is clipped to this image.
+ */
+bool LTexture::blitPixels(LTexture* source, int x, int y, Uint32 key) {
+	if (mSurfacePixels == NULL || source->mSurfacePixels == NULL ||
+			mSurfacePixels->format->format != source->mSurfacePixels->format->format) {
+		return false;
+	}
+
+	int firstCol = std::max(-x, 0);
+	int lastCol = std::min(source->mWidth, mWidth - x);
+	int firstRow = std::max(-y, 0);
+	int lastRow = std::min(source->mHeight, mHeight - y);
+	for (int row = firstRow; row < lastRow && firstCol < lastCol; row++) {
+		pixelBlitKeyed(getPixels32() + (y + row) * getPitch32() + x + firstCol,
+									 source->getPixels32() + row * source->getPitch32() + firstCol,
+									 lastCol - firstCol, key);
+	}
+	return true;
+}
+
+/**
+ * Add a changed area, clipped to the image
+ * Any marked areas it overlaps are merged into it until it overlaps none, so
+ * no pixel is uploaded twice
+ */
+void LTexture::markDirty(SDL_Rect rect) {
+	SDL_Rect bounds = {0, 0, mWidth, mHeight};
+	if (!SDL_IntersectRect(&rect, &bounds, &rect)) {
+		return;
+	}
+
+	for (size_t i = 0; i < mDirtyRects.size();) {
+		if (SDL_HasIntersection(&rect, &mDirtyRects[i])) {
+			SDL_UnionRect(&rect, &mDirtyRects[i], &rect);
+			mDirtyRects[i] = mDirtyRects.back();
+			mDirtyRects.pop_back();
+			i = 0; // The grown rectangle may now reach earlier ones
+		} else {
+			i++;
+		}
+	}
+	mDirtyRects.push_back(rect);
+}
+
+/**
+ * Upload the dirty areas of a frame and clear them
+ * pixels is the whole frame in the texture's format, each area is read from
+ * its place in it. Planar (YUV) textures are not supported.
+ */
+bool LTexture::updateDirty(const void* pixels, int pitch) {
+	Uint32 format;
+	if (mTexture == NULL || SDL_QueryTexture(mTexture, &format, NULL, NULL, NULL) != 0) {
+		return false;
+	}
+	if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+		std::cout << "Partial updates need a packed pixel format: " <<
+			SDL_GetPixelFormatName(format) << '\n';
+		return false;
+	}
+	int bytesPerPixel = SDL_BYTESPERPIXEL(format);
+
+	size_t dirtyArea = 0;
+	for (auto & rect: mDirtyRects) {
+		dirtyArea += (size_t) rect.w * rect.h;
+	}
+
+	bool success = true;
+	if (dirtyArea >= FULL_UPDATE_SHARE * mWidth * mHeight) {
+		success = SDL_UpdateTexture(mTexture, NULL, pixels, pitch) == 0;
+	} else {
+		for (auto & rect: mDirtyRects) {
+			const Uint8* start = static_cast<const Uint8*>(pixels) + rect.y * pitch +
+				rect.x * bytesPerPixel;
+			if (SDL_UpdateTexture(mTexture, &rect, start, pitch) != 0) {
+				success = false;
+			}
+		}
+	}
+	mDirtyRects.clear();
+
+	if (!success) {
+		std::cout << "Unable to update texture: " << SDL_GetError() << '\n';
+	}
+	return success;
+}
+
+int LTexture::getDirtyCount() {
+	return mDirtyRects.size();
+}
+
 bool LTexture::lockTexture() {
 	if (mRawPixels != NULL) {
 		std::cout << "Texture already locked\n";
@@ -295,3 +856,11 @@ bool LTexture::unlockTexture() {
 	mRawPitch = 0;
 	return true;
 }
+
+void* LTexture::getRawPixels() {
+	return mRawPixels;
+}
+
+int LTexture::getRawPitch() {
+	return mRawPitch;
+}
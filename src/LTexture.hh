@@ -5,15 +5,54 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <string>
+#include <vector>
+
+// Options for turning an image file into a texture
+struct LTextureOptions {
+	bool colorKey = true; // Make pixels of the key color transparent
+	SDL_Color key = {0, 0xff, 0xff, 0xff}; // Cyan, alpha is ignored
+
+	// 32 bit pixel format with 8 bit channels and alpha, or
+	// SDL_PIXELFORMAT_UNKNOWN for the renderer's preferred format
+	Uint32 format = SDL_PIXELFORMAT_UNKNOWN;
+
+	bool premultiply = false; // Store color multiplied by alpha
+	SDL_TextureAccess access = SDL_TEXTUREACCESS_STATIC;
+};
+
+// Start of a baked image (see LTexture::bakeImage), followed by dataSize bytes
+// of pixels stored row by row without padding, raw or compressed with
+// lzCompress
+struct BakedImageHeader {
+	char magic[4]; // "LIMG"
+	Uint16 version;
+	Uint16 flags; // BakedImageFlags
+	Uint32 format; // 32 bit SDL pixel format
+	Uint32 width;
+	Uint32 height;
+	Uint32 dataSize;
+};
+
+enum BakedImageFlags {
+	BAKED_COMPRESSED = 1,
+	BAKED_PREMULTIPLIED = 2,
+};
 
 // Texture Wrapper Class
 class LTexture {
 	public:
+		static const int BAKED_VERSION = 1;
+
+		// Dirty areas covering at least this share of the image are uploaded as
+		// one full update, which costs less than many small ones
+		static constexpr double FULL_UPDATE_SHARE = 0.5;
+
 		LTexture(); // Constructor
 
 		~LTexture(); // Destructor
 
-		bool loadFromFile(std::string, SDL_Renderer*); // Load image into texture
+		// Load image into texture
+		bool loadFromFile(std::string, SDL_Renderer*, LTextureOptions = LTextureOptions());
 
 		bool loadFromFile(std::string, SDL_Renderer*, SDL_Window*); // Load image into texture using pixel loaders
 
@@ -21,6 +60,22 @@ class LTexture {
 
 		bool loadFromPixels(SDL_Renderer*); //Create image from loaded pixels
 
+		bool loadFromSurface(SDL_Surface*, SDL_Renderer*); // Create from decoded surface
+
+		bool loadFromBaked(std::string, SDL_Renderer*); // Map a baked image in place
+
+		// Upload pixels from convertImage: pixels, width, height, renderer, options
+		bool loadFromConverted(const void*, int, int, SDL_Renderer*, LTextureOptions);
+
+		// Steps of loadFromFile that need no renderer, for loading on other threads
+		static SDL_Surface* decodeImage(std::string);
+		static bool convertImage(SDL_Surface*, std::vector<Uint32>&, LTextureOptions);
+		static Uint32 getNativeFormat(SDL_Renderer*); // Format used for UNKNOWN
+
+		// Convert an image ahead of time: image path, baked path, options, compress
+		static bool bakeImage(std::string, std::string, LTextureOptions = LTextureOptions(),
+													bool = false);
+
 		bool loadFromRenderedText(std::string, SDL_Color, SDL_Renderer*, TTF_Font*); // Image from font
 
 		bool createBlank(int, int, SDL_Renderer*); // Create blank texture
@@ -45,14 +100,39 @@ class LTexture {
 		int getWidth();
 		int getHeight();
 
+		SDL_Texture* getTexture(); // Underlying texture for batched drawing
+
 		// Pixel getters
 		Uint32* getPixels32();
 		Uint32 getPixel32(Uint32, Uint32); // Get a specific pixel
 		Uint32 getPitch32();
 
-		void copyRawPixels32(void*);
+		// Operations on loaded pixels, between loadPixelsFromFile and loadFromPixels
+		// Return false when no pixels are loaded
+		bool replacePixels(Uint32, Uint32); // Key, replacement
+		bool tintPixels(Uint8, Uint8, Uint8);
+		bool multiplyPixelAlpha(Uint8);
+		bool premultiplyPixels();
+		bool grayscalePixels();
+		bool blitPixels(LTexture*, int, int, Uint32); // Source, point, key to skip
+
+		// Streaming access, pixels and pitch are only valid while locked
+		// Producers can write frames straight into the locked pixels
 		bool lockTexture();
 		bool unlockTexture();
+		void* getRawPixels();
+		int getRawPitch();
+
+		void copyRawPixels32(const void*); // Copy rows packed at image width
+		void copyRawPixels32(const void*, int); // Copy rows given their pitch
+
+		// Partial uploads for textures fed from a frame kept by the caller
+		// Changed areas are marked as they happen, overlapping ones are merged,
+		// and updateDirty uploads only those areas of the frame, which must be in
+		// the texture's own packed format
+		void markDirty(SDL_Rect);
+		bool updateDirty(const void*, int); // Frame pixels, pitch
+		int getDirtyCount();
 
 	private:
 		SDL_Texture* mTexture;
@@ -63,6 +143,8 @@ class LTexture {
 		void* mRawPixels;
 		int mRawPitch;
 
+		std::vector<SDL_Rect> mDirtyRects; // Never overlapping
+
 		int mWidth;
 		int mHeight;
 };
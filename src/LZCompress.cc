@@ -0,0 +1,138 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "LZCompress.hh"
+
+#define LZ_MIN_MATCH (4)
+#define LZ_HASH_BITS (14)
+#define LZ_MAX_OFFSET (0xffff)
+
+// Add a length that did not fit in its half of the token
+static void writeLength(std::vector<Uint8>& output, size_t length) {
+	while (length >= 0xff) {
+		output.push_back(0xff);
+		length -= 0xff;
+	}
+	output.push_back(length);
+}
+
+// Literals, then a match unless matchLength is 0
+static void writeSequence(std::vector<Uint8>& output, const Uint8* literals,
+													size_t literalLength, size_t offset, size_t matchLength) {
+	size_t matchCode = matchLength > 0 ? matchLength - LZ_MIN_MATCH : 0;
+	output.push_back((std::min(literalLength, (size_t) 15) << 4) | std::min(matchCode, (size_t) 15));
+	if (literalLength >= 15) {
+		writeLength(output, literalLength - 15);
+	}
+	output.insert(output.end(), literals, literals + literalLength);
+
+	if (matchLength > 0) {
+		output.push_back(offset & 0xff);
+		output.push_back(offset >> 8);
+		if (matchCode >= 15) {
+			writeLength(output, matchCode - 15);
+		}
+	}
+}
+
+/**
+ * Find repeats by hashing every 4 byte sequence and checking the last place
+ * the same hash was seen. Only one candidate is tried per position, which
+ * trades some ratio for speed.
+ */
+size_t lzCompress(const Uint8* input, size_t size, std::vector<Uint8>& output) {
+	output.clear();
+	output.reserve(size + size / 255 + 16);
+
+	// Positions plus one, so 0 means empty
+	std::vector<size_t> table(1 << LZ_HASH_BITS, 0);
+
+	size_t anchor = 0; // Start of literals not written yet
+	size_t i = 0;
+	while (i + LZ_MIN_MATCH <= size) {
+		Uint32 sequence;
+		memcpy(&sequence, input + i, sizeof(sequence));
+		Uint32 hash = (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+		size_t candidate = table[hash];
+		table[hash] = i + 1;
+
+		if (candidate == 0 || i - (candidate - 1) > LZ_MAX_OFFSET ||
+				memcmp(input + candidate - 1, input + i, LZ_MIN_MATCH) != 0) {
+			i++;
+			continue;
+		}
+
+		size_t match = candidate - 1;
+		size_t length = LZ_MIN_MATCH;
+		while (i + length < size && input[match + length] == input[i + length]) {
+			length++;
+		}
+
+		writeSequence(output, input + anchor, i - anchor, i - match, length);
+		i += length;
+		anchor = i;
+	}
+
+	writeSequence(output, input + anchor, size - anchor, 0, 0);
+	return output.size();
+}
+
+// Read a length continued past its token half, false if input runs out
+static bool readLength(const Uint8* input, size_t size, size_t* pos, size_t* length) {
+	Uint8 byte;
+	do {
+		if (*pos >= size) {
+			return false;
+		}
+		byte = input[(*pos)++];
+		*length += byte;
+	} while (byte == 0xff);
+	return true;
+}
+
+bool lzDecompress(const Uint8* input, size_t size, Uint8* output, size_t outputSize) {
+	size_t in = 0;
+	size_t out = 0;
+	while (in < size) {
+		Uint8 token = input[in++];
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !readLength(input, size, &in, &literalLength)) {
+			return false;
+		}
+		if (literalLength > size - in || literalLength > outputSize - out) {
+			return false;
+		}
+		memcpy(output + out, input + in, literalLength);
+		in += literalLength;
+		out += literalLength;
+
+		if (in == size) { // Last sequence
+			break;
+		}
+
+		if (size - in < 2) {
+			return false;
+		}
+		size_t offset = input[in] | (input[in + 1] << 8);
+		in += 2;
+		size_t matchLength = token & 0xf;
+		if (matchLength == 15 && !readLength(input, size, &in, &matchLength)) {
+			return false;
+		}
+		matchLength += LZ_MIN_MATCH;
+		if (offset == 0 || offset > out || matchLength > outputSize - out) {
+			return false;
+		}
+
+		// Byte at a time since the match may overlap what it is writing
+		const Uint8* match = output + out - offset;
+		for (size_t j = 0; j < matchLength; j++) {
+			output[out + j] = match[j];
+		}
+		out += matchLength;
+	}
+	return out == outputSize;
+}
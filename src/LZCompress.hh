@@ -0,0 +1,21 @@
+#ifndef LZCOMPRESS
+#define LZCOMPRESS
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Fast byte compression in the style of LZ4, used by baked images
+// Data is stored as sequences of a token byte, literal bytes copied as they
+// are, and a match copying earlier output. The token holds the literal
+// count in its high half and the match length minus 4 in its low half; a
+// half of 15 is continued by bytes added on until one below 255. A match
+// offset is 2 bytes, low byte first. The last sequence has literals only.
+
+// Compress size bytes into output, returns compressed size
+size_t lzCompress(const Uint8*, size_t, std::vector<Uint8>&);
+
+// Expand compressed bytes into a buffer of exactly the original size
+// Returns false if the data is corrupt or does not fill the buffer
+bool lzDecompress(const Uint8*, size_t, Uint8*, size_t);
+
+#endif
@@ -0,0 +1,63 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <vector>
+
+#include "MultiRectCollider.hh"
+
+MultiRectCollider::MultiRectCollider() {
+	mLocalBounds = {0, 0, 0, 0};
+	mBounds = {0, 0, 0, 0};
+	mPosX = 0;
+	mPosY = 0;
+}
+
+void MultiRectCollider::addRect(int x, int y, int w, int h) {
+	SDL_Rect offset = {x, y, w, h};
+
+	// Grow the bounds to include the new rect
+	if (mOffsets.empty()) {
+		mLocalBounds = offset;
+	} else {
+		int left = std::min(mLocalBounds.x, x);
+		int top = std::min(mLocalBounds.y, y);
+		int right = std::max(mLocalBounds.x + mLocalBounds.w, x + w);
+		int bottom = std::max(mLocalBounds.y + mLocalBounds.h, y + h);
+		mLocalBounds = {left, top, right - left, bottom - top};
+	}
+
+	mOffsets.push_back(offset);
+	mRects.push_back({mPosX + x, mPosY + y, w, h});
+	mBounds = {mPosX + mLocalBounds.x, mPosY + mLocalBounds.y, mLocalBounds.w, mLocalBounds.h};
+}
+
+void MultiRectCollider::clear() {
+	mOffsets.clear();
+	mRects.clear();
+	mLocalBounds = {0, 0, 0, 0};
+	mBounds = {mPosX, mPosY, 0, 0};
+}
+
+void MultiRectCollider::setPosition(int x, int y) {
+	mPosX = x;
+	mPosY = y;
+
+	for (size_t i = 0; i < mOffsets.size(); i++) {
+		mRects[i].x = x + mOffsets[i].x;
+		mRects[i].y = y + mOffsets[i].y;
+	}
+	mBounds.x = x + mLocalBounds.x;
+	mBounds.y = y + mLocalBounds.y;
+}
+
+// Getters
+const std::vector<SDL_Rect>& MultiRectCollider::getRects() const {
+	return mRects;
+}
+
+const SDL_Rect& MultiRectCollider::getBounds() const {
+	return mBounds;
+}
+
+size_t MultiRectCollider::size() const {
+	return mRects.size();
+}
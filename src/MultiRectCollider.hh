@@ -0,0 +1,31 @@
+#ifndef MULTIRECTCOLLIDER
+#define MULTIRECTCOLLIDER
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Collider made of several rectangles that move together
+// Rects are added relative to the collider's origin; setting the position
+// shifts them all into place in one contiguous array and moves the box
+// bounding all of them, so checks can reject on that box before comparing
+// the rects pair by pair.
+class MultiRectCollider {
+	public:
+		MultiRectCollider();
+
+		void addRect(int, int, int, int); // Offset from the origin and size
+		void clear();
+		void setPosition(int, int);
+
+		const std::vector<SDL_Rect>& getRects() const;
+		const SDL_Rect& getBounds() const;
+		size_t size() const;
+
+	private:
+		std::vector<SDL_Rect> mOffsets; // Rects relative to the origin
+		std::vector<SDL_Rect> mRects; // Rects at the current position
+		SDL_Rect mLocalBounds; // Bounds relative to the origin
+		SDL_Rect mBounds; // Bounds at the current position
+		int mPosX, mPosY;
+};
+#endif
@@ -35,24 +35,87 @@ bool Particle::isDead() {
 	return mFrame > 10;
 }
 
-ParticleDot::ParticleDot(LTexture* textures) {
-	mPosX = 0;
-	mPosY = 0;
+ParticleSystem::ParticleSystem(int capacity) : mPosX(capacity), mPosY(capacity),
+		mFrame(capacity), mTexture(capacity) {
+	mCount = capacity;
+	mRandom = 0x9e3779b9;
 
-	mVelX = 0;
-	mVelY = 0;
+	for (int i = 0; i < mCount; i++) {
+		spawn(i, 0, 0);
+	}
+}
 
-	for (int i = 0; i < TOTAL_PARTICLES; i++) {
-		particles[i] = new Particle(mPosX, mPosY, textures);
+// Respawn the particles past their last frame, before they are drawn
+void ParticleSystem::update(int x, int y) {
+	for (int i = 0; i < mCount; i++) {
+		if (mFrame[i] > MAX_FRAME) {
+			spawn(i, x, y);
+		}
 	}
 }
 
-ParticleDot::~ParticleDot() {
-	for (int i = 0; i < TOTAL_PARTICLES; i++ ) {
-		delete particles[i];
+/**
+ * Draw the particles one texture at a time, then the shimmer on every other
+ * frame. Each pass shares a texture so it is submitted as a single batch.
+ * Particles age once they are drawn, as in Particle::render.
+ */
+void ParticleSystem::render(SDL_Renderer* renderer, LTexture* textures,
+														LTexture* shimmerTexture) {
+	for (int t = 0; t < TOTAL_PARTICLE_TEXTURES; t++) {
+		for (int i = 0; i < mCount; i++) {
+			if (mTexture[i] == t) {
+				mBatch.draw(renderer, &textures[t], mPosX[i], mPosY[i]);
+			}
+		}
+	}
+
+	for (int i = 0; i < mCount; i++) {
+		if (mFrame[i] % 2 == 0) {
+			mBatch.draw(renderer, shimmerTexture, mPosX[i], mPosY[i]);
+		}
+	}
+	mBatch.flush(renderer);
+
+	age();
+}
+
+int ParticleSystem::getCount() {
+	return mCount;
+}
+
+// No branches so the compiler can vectorize it
+void ParticleSystem::age() {
+	Uint8* frames = mFrame.data();
+	for (int i = 0; i < mCount; i++) {
+		frames[i]++;
 	}
 }
 
+// Same offsets as Particle around the given point
+void ParticleSystem::spawn(int i, int x, int y) {
+	mPosX[i] = x - 5 + random(25);
+	mPosY[i] = y - 5 + random(25);
+	mFrame[i] = random(5);
+	mTexture[i] = random(TOTAL_PARTICLE_TEXTURES);
+}
+
+// Xorshift is much cheaper than rand() and keeps its state per system
+Uint32 ParticleSystem::random(Uint32 bound) {
+	mRandom ^= mRandom << 13;
+	mRandom ^= mRandom >> 17;
+	mRandom ^= mRandom << 5;
+	// Scale into range with a multiply instead of a modulo
+	return ((Uint64) mRandom * bound) >> 32;
+}
+
+ParticleDot::ParticleDot() : mParticles(TOTAL_PARTICLES) {
+	mPosX = 0;
+	mPosY = 0;
+
+	mVelX = 0;
+	mVelY = 0;
+}
+
 void ParticleDot::handleEvent(SDL_Event& e) {
 	// Start moving dot
 	// e.key.repeat makes sure we only look at the first key press
@@ -108,19 +171,6 @@ void ParticleDot::render(LTexture* dotTexture, LTexture* textures,
 												 LTexture* shimmerTexture, SDL_Renderer* renderer) {
 	dotTexture->render(renderer, mPosX, mPosY);
 
-	renderParticles(textures, shimmerTexture, renderer);
-}
-
-void ParticleDot::renderParticles(LTexture* textures, LTexture* shimmerTexture,
-																	SDL_Renderer* renderer) {
-	for (int i = 0; i < TOTAL_PARTICLES; i++) { // Reset dead particles
-		if (particles[i]->isDead()) {
-			delete particles[i];
-			particles[i] = new Particle(mPosX, mPosY, textures);
-		}
-	}
-
-	for (int i = 0; i < TOTAL_PARTICLES; i++) {
-		particles[i]->render(shimmerTexture, renderer);
-	}
+	mParticles.update(mPosX, mPosY);
+	mParticles.render(renderer, textures, shimmerTexture);
 }
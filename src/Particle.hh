@@ -2,10 +2,13 @@
 #define PARTICLE
 
 #include <SDL2/SDL.h>
+#include <vector>
 
 #include "LTexture.hh"
+#include "LSpriteBatch.hh"
 
 #define TOTAL_PARTICLES (20)
+#define TOTAL_PARTICLE_TEXTURES (3)
 class Particle {
 	public:
 		Particle(int, int, LTexture*);
@@ -17,17 +20,46 @@ class Particle {
 		LTexture *mTexture;
 };
 
+// Fixed size pool of particles stored as separate arrays per attribute
+// Dead particles are respawned in place, so nothing is allocated after
+// construction, and each attribute is a tight array the update loop can
+// stream through
+class ParticleSystem {
+	public:
+		static const int MAX_FRAME = 10; // Particles die after this frame
+
+		ParticleSystem(int); // Capacity
+
+		void update(int, int); // Respawn dead particles at point
+		void render(SDL_Renderer*, LTexture*, LTexture*); // Textures, shimmer, then age
+
+		int getCount();
+
+	private:
+		int mCount;
+		std::vector<int> mPosX;
+		std::vector<int> mPosY;
+		std::vector<Uint8> mFrame;
+		std::vector<Uint8> mTexture; // Index into the particle textures
+
+		Uint32 mRandom; // Xorshift state
+
+		LSpriteBatch mBatch;
+
+		void age();
+		void spawn(int, int, int); // Index, point
+		Uint32 random(Uint32); // Random number below the given bound
+};
+
 class ParticleDot {
 	public:
-		ParticleDot(LTexture*);
-		~ParticleDot();
+		ParticleDot();
 		void handleEvent(SDL_Event&);
 		void move();
 		void render(LTexture*, LTexture*, LTexture*, SDL_Renderer*);
 	
 	private:
-		Particle* particles[TOTAL_PARTICLES];
-		void renderParticles(LTexture*, LTexture*, SDL_Renderer*);
+		ParticleSystem mParticles;
 
 		int mPosX, mPosY;
 		int mVelX, mVelY;
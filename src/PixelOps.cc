@@ -0,0 +1,364 @@
+#include <SDL2/SDL.h>
+
+#include "PixelOps.hh"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PIXELOPS_X86
+#include <immintrin.h>
+#endif
+
+// One set of kernels per instruction set
+struct PixelKernels {
+	const char* name;
+	void (*replaceKey)(Uint32*, size_t, Uint32, Uint32);
+	void (*multiply)(Uint32*, size_t, Uint32); // Factor per byte
+	void (*premultiply)(Uint32*, size_t, int); // Alpha shift
+	void (*grayscale)(Uint32*, size_t, int, int, int, Uint32); // Color shifts, kept bits
+	void (*blitKeyed)(Uint32*, const Uint32*, size_t, Uint32);
+};
+
+// x * y / 255 rounded, exact for x and y up to 255
+static inline Uint32 mulDiv255(Uint32 x, Uint32 y) {
+	Uint32 product = x * y + 128;
+	return (product + (product >> 8)) >> 8;
+}
+
+// Multiply each byte of a pixel by the matching byte of factors
+static inline Uint32 multiplyBytes(Uint32 pixel, Uint32 factors) {
+	Uint32 result = 0;
+	for (int shift = 0; shift < 32; shift += 8) {
+		result |= mulDiv255((pixel >> shift) & 0xff, (factors >> shift) & 0xff) << shift;
+	}
+	return result;
+}
+
+// Factors that scale every byte by the pixel's alpha except alpha itself
+static inline Uint32 alphaFactors(Uint32 pixel, int alphaShift) {
+	Uint32 alpha = (pixel >> alphaShift) & 0xff;
+	Uint32 alphaMask = 0xffu << alphaShift;
+	return ((alpha * 0x01010101) & ~alphaMask) | alphaMask;
+}
+
+static inline Uint32 luminance(Uint32 r, Uint32 g, Uint32 b) {
+	return (r * 77 + g * 150 + b * 29) >> 8; // Weights add up to 256
+}
+
+// Scalar kernels, also used for the ends of runs the vector kernels leave
+static void replaceKeyScalar(Uint32* pixels, size_t count, Uint32 key, Uint32 replacement) {
+	for (size_t i = 0; i < count; i++) {
+		if (pixels[i] == key) {
+			pixels[i] = replacement;
+		}
+	}
+}
+
+static void multiplyScalar(Uint32* pixels, size_t count, Uint32 factors) {
+	for (size_t i = 0; i < count; i++) {
+		pixels[i] = multiplyBytes(pixels[i], factors);
+	}
+}
+
+static void premultiplyScalar(Uint32* pixels, size_t count, int alphaShift) {
+	for (size_t i = 0; i < count; i++) {
+		pixels[i] = multiplyBytes(pixels[i], alphaFactors(pixels[i], alphaShift));
+	}
+}
+
+static void grayscaleScalar(Uint32* pixels, size_t count, int rShift, int gShift, int bShift,
+														Uint32 keep) {
+	for (size_t i = 0; i < count; i++) {
+		Uint32 gray = luminance((pixels[i] >> rShift) & 0xff, (pixels[i] >> gShift) & 0xff,
+														(pixels[i] >> bShift) & 0xff);
+		pixels[i] = (pixels[i] & keep) | (gray << rShift) | (gray << gShift) | (gray << bShift);
+	}
+}
+
+static void blitKeyedScalar(Uint32* target, const Uint32* source, size_t count, Uint32 key) {
+	for (size_t i = 0; i < count; i++) {
+		if (source[i] != key) {
+			target[i] = source[i];
+		}
+	}
+}
+
+static const PixelKernels SCALAR_KERNELS = {
+	"scalar", replaceKeyScalar, multiplyScalar, premultiplyScalar, grayscaleScalar, blitKeyedScalar
+};
+
+#ifdef PIXELOPS_X86
+// SSE2 kernels, 4 pixels at a time
+// Byte multiplies widen each half of the vector to 16 bit lanes, multiply,
+// divide by 255 with the same rounding as mulDiv255, and pack back
+
+__attribute__((target("sse2")))
+static inline __m128i multiplyBytesSSE2(__m128i pixels, __m128i factors) {
+	__m128i zero = _mm_setzero_si128();
+	__m128i round = _mm_set1_epi16(128);
+	__m128i low = _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), _mm_unpacklo_epi8(factors, zero));
+	__m128i high = _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), _mm_unpackhi_epi8(factors, zero));
+	low = _mm_add_epi16(low, round);
+	high = _mm_add_epi16(high, round);
+	low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+	high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+	return _mm_packus_epi16(low, high);
+}
+
+__attribute__((target("sse2")))
+static void replaceKeySSE2(Uint32* pixels, size_t count, Uint32 key, Uint32 replacement) {
+	__m128i keys = _mm_set1_epi32(key);
+	__m128i replacements = _mm_set1_epi32(replacement);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i block = _mm_loadu_si128((__m128i*) (pixels + i));
+		__m128i match = _mm_cmpeq_epi32(block, keys);
+		block = _mm_or_si128(_mm_andnot_si128(match, block), _mm_and_si128(match, replacements));
+		_mm_storeu_si128((__m128i*) (pixels + i), block);
+	}
+	replaceKeyScalar(pixels + i, count - i, key, replacement);
+}
+
+__attribute__((target("sse2")))
+static void multiplySSE2(Uint32* pixels, size_t count, Uint32 factors) {
+	__m128i factorBlock = _mm_set1_epi32(factors);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i block = _mm_loadu_si128((__m128i*) (pixels + i));
+		_mm_storeu_si128((__m128i*) (pixels + i), multiplyBytesSSE2(block, factorBlock));
+	}
+	multiplyScalar(pixels + i, count - i, factors);
+}
+
+__attribute__((target("sse2")))
+static void premultiplySSE2(Uint32* pixels, size_t count, int alphaShift) {
+	__m128i shift = _mm_cvtsi32_si128(alphaShift);
+	__m128i byteMask = _mm_set1_epi32(0xff);
+	__m128i alphaMask = _mm_set1_epi32(0xffu << alphaShift);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i block = _mm_loadu_si128((__m128i*) (pixels + i));
+		__m128i alpha = _mm_and_si128(_mm_srl_epi32(block, shift), byteMask);
+		alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+		alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+		__m128i factors = _mm_or_si128(_mm_andnot_si128(alphaMask, alpha), alphaMask);
+		_mm_storeu_si128((__m128i*) (pixels + i), multiplyBytesSSE2(block, factors));
+	}
+	premultiplyScalar(pixels + i, count - i, alphaShift);
+}
+
+// Channels sit in the low 16 bits of 32 bit lanes, so 16 bit multiplies work
+// and the weighted sum still fits
+__attribute__((target("sse2")))
+static void grayscaleSSE2(Uint32* pixels, size_t count, int rShift, int gShift, int bShift,
+													Uint32 keep) {
+	__m128i rCount = _mm_cvtsi32_si128(rShift);
+	__m128i gCount = _mm_cvtsi32_si128(gShift);
+	__m128i bCount = _mm_cvtsi32_si128(bShift);
+	__m128i byteMask = _mm_set1_epi32(0xff);
+	__m128i keepMask = _mm_set1_epi32(keep);
+	__m128i rWeight = _mm_set1_epi32(77);
+	__m128i gWeight = _mm_set1_epi32(150);
+	__m128i bWeight = _mm_set1_epi32(29);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i block = _mm_loadu_si128((__m128i*) (pixels + i));
+		__m128i r = _mm_and_si128(_mm_srl_epi32(block, rCount), byteMask);
+		__m128i g = _mm_and_si128(_mm_srl_epi32(block, gCount), byteMask);
+		__m128i b = _mm_and_si128(_mm_srl_epi32(block, bCount), byteMask);
+		__m128i gray = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi16(r, rWeight),
+																							 _mm_mullo_epi16(g, gWeight)),
+																 _mm_mullo_epi16(b, bWeight));
+		gray = _mm_srli_epi32(gray, 8);
+		block = _mm_or_si128(_mm_and_si128(block, keepMask),
+												 _mm_or_si128(_mm_sll_epi32(gray, rCount),
+																			_mm_or_si128(_mm_sll_epi32(gray, gCount),
+																									 _mm_sll_epi32(gray, bCount))));
+		_mm_storeu_si128((__m128i*) (pixels + i), block);
+	}
+	grayscaleScalar(pixels + i, count - i, rShift, gShift, bShift, keep);
+}
+
+__attribute__((target("sse2")))
+static void blitKeyedSSE2(Uint32* target, const Uint32* source, size_t count, Uint32 key) {
+	__m128i keys = _mm_set1_epi32(key);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i sourceBlock = _mm_loadu_si128((const __m128i*) (source + i));
+		__m128i targetBlock = _mm_loadu_si128((__m128i*) (target + i));
+		__m128i match = _mm_cmpeq_epi32(sourceBlock, keys);
+		targetBlock = _mm_or_si128(_mm_and_si128(match, targetBlock),
+															 _mm_andnot_si128(match, sourceBlock));
+		_mm_storeu_si128((__m128i*) (target + i), targetBlock);
+	}
+	blitKeyedScalar(target + i, source + i, count - i, key);
+}
+
+static const PixelKernels SSE2_KERNELS = {
+	"sse2", replaceKeySSE2, multiplySSE2, premultiplySSE2, grayscaleSSE2, blitKeyedSSE2
+};
+
+// AVX2 kernels, the SSE2 ones widened to 8 pixels
+// Unpacking and packing both work within 128 bit halves, so pixels come back
+// in order
+
+__attribute__((target("avx2")))
+static inline __m256i multiplyBytesAVX2(__m256i pixels, __m256i factors) {
+	__m256i zero = _mm256_setzero_si256();
+	__m256i round = _mm256_set1_epi16(128);
+	__m256i low = _mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero),
+																	 _mm256_unpacklo_epi8(factors, zero));
+	__m256i high = _mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero),
+																		_mm256_unpackhi_epi8(factors, zero));
+	low = _mm256_add_epi16(low, round);
+	high = _mm256_add_epi16(high, round);
+	low = _mm256_srli_epi16(_mm256_add_epi16(low, _mm256_srli_epi16(low, 8)), 8);
+	high = _mm256_srli_epi16(_mm256_add_epi16(high, _mm256_srli_epi16(high, 8)), 8);
+	return _mm256_packus_epi16(low, high);
+}
+
+__attribute__((target("avx2")))
+static void replaceKeyAVX2(Uint32* pixels, size_t count, Uint32 key, Uint32 replacement) {
+	__m256i keys = _mm256_set1_epi32(key);
+	__m256i replacements = _mm256_set1_epi32(replacement);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i block = _mm256_loadu_si256((__m256i*) (pixels + i));
+		__m256i match = _mm256_cmpeq_epi32(block, keys);
+		_mm256_storeu_si256((__m256i*) (pixels + i), _mm256_blendv_epi8(block, replacements, match));
+	}
+	replaceKeyScalar(pixels + i, count - i, key, replacement);
+}
+
+__attribute__((target("avx2")))
+static void multiplyAVX2(Uint32* pixels, size_t count, Uint32 factors) {
+	__m256i factorBlock = _mm256_set1_epi32(factors);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i block = _mm256_loadu_si256((__m256i*) (pixels + i));
+		_mm256_storeu_si256((__m256i*) (pixels + i), multiplyBytesAVX2(block, factorBlock));
+	}
+	multiplyScalar(pixels + i, count - i, factors);
+}
+
+__attribute__((target("avx2")))
+static void premultiplyAVX2(Uint32* pixels, size_t count, int alphaShift) {
+	__m128i shift = _mm_cvtsi32_si128(alphaShift);
+	__m256i byteMask = _mm256_set1_epi32(0xff);
+	__m256i alphaMask = _mm256_set1_epi32(0xffu << alphaShift);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i block = _mm256_loadu_si256((__m256i*) (pixels + i));
+		__m256i alpha = _mm256_and_si256(_mm256_srl_epi32(block, shift), byteMask);
+		alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 8));
+		alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 16));
+		__m256i factors = _mm256_or_si256(_mm256_andnot_si256(alphaMask, alpha), alphaMask);
+		_mm256_storeu_si256((__m256i*) (pixels + i), multiplyBytesAVX2(block, factors));
+	}
+	premultiplyScalar(pixels + i, count - i, alphaShift);
+}
+
+__attribute__((target("avx2")))
+static void grayscaleAVX2(Uint32* pixels, size_t count, int rShift, int gShift, int bShift,
+													Uint32 keep) {
+	__m128i rCount = _mm_cvtsi32_si128(rShift);
+	__m128i gCount = _mm_cvtsi32_si128(gShift);
+	__m128i bCount = _mm_cvtsi32_si128(bShift);
+	__m256i byteMask = _mm256_set1_epi32(0xff);
+	__m256i keepMask = _mm256_set1_epi32(keep);
+	__m256i rWeight = _mm256_set1_epi32(77);
+	__m256i gWeight = _mm256_set1_epi32(150);
+	__m256i bWeight = _mm256_set1_epi32(29);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i block = _mm256_loadu_si256((__m256i*) (pixels + i));
+		__m256i r = _mm256_and_si256(_mm256_srl_epi32(block, rCount), byteMask);
+		__m256i g = _mm256_and_si256(_mm256_srl_epi32(block, gCount), byteMask);
+		__m256i b = _mm256_and_si256(_mm256_srl_epi32(block, bCount), byteMask);
+		__m256i gray = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi16(r, rWeight),
+																										 _mm256_mullo_epi16(g, gWeight)),
+																		_mm256_mullo_epi16(b, bWeight));
+		gray = _mm256_srli_epi32(gray, 8);
+		block = _mm256_or_si256(_mm256_and_si256(block, keepMask),
+														_mm256_or_si256(_mm256_sll_epi32(gray, rCount),
+																						_mm256_or_si256(_mm256_sll_epi32(gray, gCount),
+																														_mm256_sll_epi32(gray, bCount))));
+		_mm256_storeu_si256((__m256i*) (pixels + i), block);
+	}
+	grayscaleScalar(pixels + i, count - i, rShift, gShift, bShift, keep);
+}
+
+__attribute__((target("avx2")))
+static void blitKeyedAVX2(Uint32* target, const Uint32* source, size_t count, Uint32 key) {
+	__m256i keys = _mm256_set1_epi32(key);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i sourceBlock = _mm256_loadu_si256((const __m256i*) (source + i));
+		__m256i targetBlock = _mm256_loadu_si256((__m256i*) (target + i));
+		__m256i match = _mm256_cmpeq_epi32(sourceBlock, keys);
+		_mm256_storeu_si256((__m256i*) (target + i),
+												_mm256_blendv_epi8(sourceBlock, targetBlock, match));
+	}
+	blitKeyedScalar(target + i, source + i, count - i, key);
+}
+
+static const PixelKernels AVX2_KERNELS = {
+	"avx2", replaceKeyAVX2, multiplyAVX2, premultiplyAVX2, grayscaleAVX2, blitKeyedAVX2
+};
+#endif
+
+// Pick the widest kernels once, on first use
+static const PixelKernels& getKernels() {
+	static const PixelKernels* kernels = []() {
+#ifdef PIXELOPS_X86
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) {
+			return &AVX2_KERNELS;
+		}
+		if (__builtin_cpu_supports("sse2")) {
+			return &SSE2_KERNELS;
+		}
+#endif
+		return &SCALAR_KERNELS;
+	}();
+	return *kernels;
+}
+
+void pixelReplaceKey(Uint32* pixels, size_t count, Uint32 key, Uint32 replacement) {
+	getKernels().replaceKey(pixels, count, key, replacement);
+}
+
+void pixelTint(Uint32* pixels, size_t count, const SDL_PixelFormat* format,
+							 Uint8 r, Uint8 g, Uint8 b) {
+	// Bytes that are not color are multiplied by 255, which keeps them
+	Uint32 colorMask = format->Rmask | format->Gmask | format->Bmask;
+	Uint32 factors = ~colorMask | (r << format->Rshift) | (g << format->Gshift) |
+		(b << format->Bshift);
+	getKernels().multiply(pixels, count, factors);
+}
+
+void pixelMultiplyAlpha(Uint32* pixels, size_t count, const SDL_PixelFormat* format, Uint8 a) {
+	if (format->Amask == 0) {
+		return;
+	}
+	getKernels().multiply(pixels, count, ~format->Amask | (a << format->Ashift));
+}
+
+void pixelPremultiply(Uint32* pixels, size_t count, const SDL_PixelFormat* format) {
+	if (format->Amask == 0) {
+		return;
+	}
+	getKernels().premultiply(pixels, count, format->Ashift);
+}
+
+void pixelGrayscale(Uint32* pixels, size_t count, const SDL_PixelFormat* format) {
+	Uint32 colorMask = format->Rmask | format->Gmask | format->Bmask;
+	getKernels().grayscale(pixels, count, format->Rshift, format->Gshift, format->Bshift,
+												 ~colorMask);
+}
+
+void pixelBlitKeyed(Uint32* target, const Uint32* source, size_t count, Uint32 key) {
+	getKernels().blitKeyed(target, source, count, key);
+}
+
+const char* getPixelOpsTarget() {
+	return getKernels().name;
+}
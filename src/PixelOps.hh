@@ -0,0 +1,32 @@
+#ifndef PIXELOPS
+#define PIXELOPS
+
+#include <SDL2/SDL.h>
+
+// Operations on runs of 32 bit pixels with 8 bits per channel
+// Each one has a scalar, SSE2 and AVX2 version. The widest one the CPU
+// supports is picked the first time any operation is used, so the same
+// program runs everywhere. The format gives the channel positions; channel
+// operations on a format without alpha leave the unused byte alone.
+
+// Replace every pixel equal to key (all 32 bits) with replacement
+void pixelReplaceKey(Uint32*, size_t, Uint32, Uint32);
+
+// Multiply color channels by r, g, b out of 255
+void pixelTint(Uint32*, size_t, const SDL_PixelFormat*, Uint8, Uint8, Uint8);
+
+// Multiply alpha by the given value out of 255
+void pixelMultiplyAlpha(Uint32*, size_t, const SDL_PixelFormat*, Uint8);
+
+// Multiply color channels by each pixel's own alpha
+void pixelPremultiply(Uint32*, size_t, const SDL_PixelFormat*);
+
+// Replace color with its luminance, alpha is kept
+void pixelGrayscale(Uint32*, size_t, const SDL_PixelFormat*);
+
+// Copy source pixels over destination, skipping pixels equal to key
+void pixelBlitKeyed(Uint32*, const Uint32*, size_t, Uint32);
+
+const char* getPixelOpsTarget(); // Name of the instruction set in use
+
+#endif
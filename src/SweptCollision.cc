@@ -0,0 +1,166 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "SweptCollision.hh"
+#include "Collision.hh"
+
+static bool rayBox(float, float, float, float, float, float, float, float, SweepHit&, float&);
+static bool rayCircle(float, float, float, float, float, float, float, SweepHit&);
+static bool touchBox(float, float, float, SweepHit&);
+
+// A moving box touches the wall when its top left corner enters the wall
+// grown by the box's size
+bool sweepRect(float x, float y, float w, float h, float dx, float dy,
+							 const SDL_Rect& wall, SweepHit& hit) {
+	float enter;
+	return rayBox(x, y, dx, dy, wall.x - w, wall.y - h, wall.x + wall.w, wall.y + wall.h,
+								hit, enter) && touchBox(enter, dx, dy, hit);
+}
+
+/**
+ * A moving circle touches the wall when its center enters the wall grown by
+ * the radius with rounded corners
+ * The center is first tested against the wall grown into a square cornered
+ * box. If it enters that box beside one of the wall's corners, it can only
+ * reach the rounded shape through the circle around that corner.
+ */
+bool sweepCircle(float x, float y, float r, float dx, float dy,
+								 const SDL_Rect& wall, SweepHit& hit) {
+	float left = wall.x;
+	float top = wall.y;
+	float right = wall.x + wall.w;
+	float bottom = wall.y + wall.h;
+
+	float enter;
+	if (!rayBox(x, y, dx, dy, left - r, top - r, right + r, bottom + r, hit, enter)) {
+		return false;
+	}
+
+	float enterX = x + dx * enter;
+	float enterY = y + dy * enter;
+	bool besideX = enterX < left || enterX > right;
+	bool besideY = enterY < top || enterY > bottom;
+	if (!besideX || !besideY) {
+		return touchBox(enter, dx, dy, hit);
+	}
+
+	float cornerX = enterX < left ? left : right;
+	float cornerY = enterY < top ? top : bottom;
+	return rayCircle(x, y, dx, dy, cornerX, cornerY, r, hit);
+}
+
+// Two circles touch when one's center reaches the other grown by its radius
+bool sweepCircle(float x, float y, float r, float dx, float dy,
+								 const Circle& other, SweepHit& hit) {
+	return rayCircle(x, y, dx, dy, other.x, other.y, r + other.r, hit);
+}
+
+/**
+ * Finds when the point x, y moving by dx, dy enters the box
+ * Uses the slabs between each pair of opposite sides: the point is in the box
+ * between entering the later slab and leaving the earlier one. enter is set
+ * to the entry time, negative when starting inside, and the hit's normal to
+ * the side entered through; touchBox decides if that counts.
+ */
+static bool rayBox(float x, float y, float dx, float dy,
+									 float left, float top, float right, float bottom,
+									 SweepHit& hit, float& enter) {
+	if (dx == 0 && dy == 0) {
+		return false;
+	}
+
+	const float inf = std::numeric_limits<float>::infinity();
+	float enterX = -inf, exitX = inf;
+	float enterY = -inf, exitY = inf;
+
+	// A point not moving along an axis must already be between those sides
+	// Touching a side is not overlapping, so sliding along one is not a hit
+	if (dx == 0) {
+		if (x <= left || x >= right) {
+			return false;
+		}
+	} else {
+		enterX = ((dx > 0 ? left : right) - x) / dx;
+		exitX = ((dx > 0 ? right : left) - x) / dx;
+	}
+	if (dy == 0) {
+		if (y <= top || y >= bottom) {
+			return false;
+		}
+	} else {
+		enterY = ((dy > 0 ? top : bottom) - y) / dy;
+		exitY = ((dy > 0 ? bottom : top) - y) / dy;
+	}
+
+	enter = std::max(enterX, enterY);
+	float exit = std::min(exitX, exitY);
+	if (enter >= exit || exit <= 0 || enter > 1) {
+		return false;
+	}
+
+	// Entered through the side of the later slab
+	if (enterX > enterY) {
+		hit.normalX = dx > 0 ? -1 : 1;
+		hit.normalY = 0;
+	} else {
+		hit.normalX = 0;
+		hit.normalY = dy > 0 ? -1 : 1;
+	}
+
+	return true;
+}
+
+// Sets the time of a box hit, starting inside only counts if just inside
+static bool touchBox(float enter, float dx, float dy, SweepHit& hit) {
+	if (enter < 0) {
+		float depth = -enter * std::fabs(dx * hit.normalX + dy * hit.normalY);
+		if (depth > SWEEP_CONTACT_SLOP) {
+			return false;
+		}
+	}
+	hit.time = std::max(enter, 0.f);
+	return true;
+}
+
+// Finds when the point x, y moving by dx, dy enters the circle
+static bool rayCircle(float x, float y, float dx, float dy,
+											float cX, float cY, float r, SweepHit& hit) {
+	float fromX = x - cX;
+	float fromY = y - cY;
+
+	// Solve |from + t * d| = r for t
+	float a = dx * dx + dy * dy;
+	float b = fromX * dx + fromY * dy;
+	float c = fromX * fromX + fromY * fromY - r * r;
+	if (a == 0) {
+		return false;
+	}
+
+	if (c < 0) {
+		// Starting inside, only a hit when just inside and moving further in
+		float distance = std::sqrt(fromX * fromX + fromY * fromY);
+		if (b >= 0 || distance == 0 || r - distance > SWEEP_CONTACT_SLOP) {
+			return false;
+		}
+		hit.time = 0;
+		hit.normalX = fromX / distance;
+		hit.normalY = fromY / distance;
+		return true;
+	}
+
+	float discriminant = b * b - a * c;
+	if (discriminant < 0) {
+		return false;
+	}
+	float t = (-b - std::sqrt(discriminant)) / a;
+	if (t < 0 || t > 1) {
+		return false;
+	}
+
+	hit.time = t;
+	hit.normalX = (fromX + dx * t) / r;
+	hit.normalY = (fromY + dy * t) / r;
+	return true;
+}
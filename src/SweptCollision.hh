@@ -0,0 +1,36 @@
+#ifndef SWEPTCOLLISION
+#define SWEPTCOLLISION
+
+#include <SDL2/SDL.h>
+
+#include "Collision.hh"
+
+// Continuous collision for shapes moving in a straight line
+// Instead of moving a whole step and testing for overlap, which stops fast
+// shapes short of a wall or lets them pass through thin ones, the sweep finds
+// the exact fraction of the move at which the shape first touches the
+// other one. The moving shape is given by float coordinates so a move can be
+// continued from a point between pixels after sliding.
+//
+// A shape starting less than SWEEP_CONTACT_SLOP pixels inside the other one
+// (left there by rounding) is hit at time 0 if it keeps moving in. Shapes
+// overlapping deeper are let go so they can get out.
+
+static const float SWEEP_CONTACT_SLOP = 1.f;
+
+// Where a sweep first touched
+typedef struct SweepHit {
+	float time; // Fraction of the move, 0 to 1
+	float normalX, normalY; // Unit normal of the touched surface
+} SweepHit;
+
+// Box with top left x, y and size w, h moved by dx, dy
+bool sweepRect(float x, float y, float w, float h, float dx, float dy,
+							 const SDL_Rect& wall, SweepHit&);
+
+// Circle with center x, y and radius r moved by dx, dy
+bool sweepCircle(float x, float y, float r, float dx, float dy,
+								 const SDL_Rect& wall, SweepHit&);
+bool sweepCircle(float x, float y, float r, float dx, float dy,
+								 const Circle& other, SweepHit&);
+#endif
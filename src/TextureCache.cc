@@ -0,0 +1,86 @@
+#include <SDL2/SDL.h>
+#include <memory>
+#include <string>
+
+#include "TextureCache.hh"
+#include "LTexture.hh"
+
+TextureCache::TextureCache(size_t budget) {
+	mBudget = budget;
+	mResidentBytes = 0;
+	mHits = 0;
+	mMisses = 0;
+}
+
+/**
+ * Return the cached texture for path and color key, or load it
+ * Entries are keyed by both since the same image keyed with another color is
+ * a different texture
+ */
+std::shared_ptr<LTexture> TextureCache::get(std::string path, SDL_Renderer* renderer,
+																						Uint8 keyR, Uint8 keyG, Uint8 keyB) {
+	std::string key = path + '#' + std::to_string((keyR << 16) | (keyG << 8) | keyB);
+
+	auto entry = mEntries.find(key);
+	if (entry != mEntries.end()) {
+		mHits++;
+		mRecent.splice(mRecent.begin(), mRecent, entry->second.recent);
+		return entry->second.texture;
+	}
+	mMisses++;
+
+	LTextureOptions options;
+	options.key = {keyR, keyG, keyB, 0xff};
+	std::shared_ptr<LTexture> texture = std::make_shared<LTexture>();
+	if (!texture->loadFromFile(path, renderer, options)) {
+		return NULL;
+	}
+
+	// Textures are counted at 4 bytes per pixel
+	size_t bytes = (size_t) texture->getWidth() * texture->getHeight() * 4;
+	mRecent.push_front(key);
+	mEntries[key] = {texture, bytes, mRecent.begin()};
+	mResidentBytes += bytes;
+
+	trim();
+	return texture;
+}
+
+// Free the least recently used textures that have no handles left
+void TextureCache::trim() {
+	auto recent = mRecent.end();
+	while (mResidentBytes > mBudget && recent != mRecent.begin()) {
+		recent--;
+		auto entry = mEntries.find(*recent);
+		if (entry->second.texture.use_count() > 1) { // Still in use
+			continue;
+		}
+
+		mResidentBytes -= entry->second.bytes;
+		mEntries.erase(entry);
+		recent = mRecent.erase(recent);
+	}
+}
+
+void TextureCache::clear() {
+	mEntries.clear();
+	mRecent.clear();
+	mResidentBytes = 0;
+}
+
+// Statistics
+int TextureCache::getHits() {
+	return mHits;
+}
+
+int TextureCache::getMisses() {
+	return mMisses;
+}
+
+size_t TextureCache::getResidentBytes() {
+	return mResidentBytes;
+}
+
+int TextureCache::getEntryCount() {
+	return mEntries.size();
+}
@@ -0,0 +1,56 @@
+#ifndef TEXTURECACHE
+#define TEXTURECACHE
+
+#include <SDL2/SDL.h>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "LTexture.hh"
+
+// Shares textures between everything that loads the same image
+// Asking for an image already in the cache with the same color key returns a
+// handle to the existing texture. Textures nobody holds a handle to stay
+// cached until the cache goes over its byte budget, then the least recently
+// used ones are freed first. Textures still in use are never freed, so the
+// budget can be exceeded while they are held.
+//
+// Handles must be released and the cache cleared before the renderer is
+// destroyed.
+class TextureCache {
+	public:
+		static const size_t DEFAULT_BUDGET = 64 * 1024 * 1024;
+
+		TextureCache(size_t = DEFAULT_BUDGET); // Budget in bytes
+
+		// Get image at path keyed with the given color, loading it on a miss
+		// Returns an empty handle if the image cannot be loaded
+		std::shared_ptr<LTexture> get(std::string, SDL_Renderer*, Uint8 = 0, Uint8 = 0xff,
+																	Uint8 = 0xff);
+
+		void trim(); // Free unused textures until under budget
+		void clear(); // Drop every cached texture
+
+		// Statistics
+		int getHits();
+		int getMisses();
+		size_t getResidentBytes();
+		int getEntryCount();
+
+	private:
+		struct CacheEntry {
+			std::shared_ptr<LTexture> texture;
+			size_t bytes;
+			std::list<std::string>::iterator recent; // Position in mRecent
+		};
+
+		size_t mBudget;
+		size_t mResidentBytes;
+		int mHits;
+		int mMisses;
+
+		std::unordered_map<std::string, CacheEntry> mEntries;
+		std::list<std::string> mRecent; // Keys, most recently used first
+};
+#endif
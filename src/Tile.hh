@@ -19,24 +19,17 @@ enum TileTypes {
 	TILE_TOPLEFT,
 };
 
-class Tile {
-	public:
-		Tile(int, int, TileTypes);
-		void render(SDL_Renderer*, SDL_Rect&, LTexture*, SDL_Rect*);
-		TileTypes getType();
-		SDL_Rect getBox();
-	
-	private:
-		SDL_Rect mBox;
-		TileTypes mType;
-};
+class TileMap;
+class ChunkedWorld;
 
 class TileDot {
 	public:
 		TileDot();
 		void handleEvent(SDL_Event&);
-		void move(Tile *tiles[]);
-		void setCamera(SDL_Rect& camera);
+		void move(TileMap&);
+		void move(ChunkedWorld&);
+		// Center camera on dot, clamped to the level width and height
+		void setCamera(SDL_Rect& camera, int, int);
 		void render(SDL_Renderer*, LTexture*, SDL_Rect& camera);
 	
 	private:
@@ -45,6 +38,4 @@ class TileDot {
 };
 
 bool checkCollision(SDL_Rect, SDL_Rect);
-bool touchesWall(SDL_Rect box, Tile* tiles[]);
-bool setTiles(Tile *tiles[]);
 #endif
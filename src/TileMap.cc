@@ -0,0 +1,329 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TileMap.hh"
+#include "Tile.hh"
+#include "LTexture.hh"
+
+#define TILE_WIDTH (80)
+#define TILE_HEIGHT (80)
+#define TOTAL_TILE_SPRITES (12)
+
+// Division rounding down, so cells left of or above the map come out negative
+static int floorDivide(int value, int divisor) {
+	int quotient = value / divisor;
+	return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+// Check the map's cells, pixels and tile count all fit in an int
+static bool validDimensions(Uint32 columns, Uint32 rows, Uint32 tileWidth, Uint32 tileHeight) {
+	return columns > 0 && rows > 0 && tileWidth > 0 && tileHeight > 0 &&
+				 (Uint64) columns * rows <= INT_MAX &&
+				 (Uint64) columns * tileWidth <= INT_MAX && (Uint64) rows * tileHeight <= INT_MAX;
+}
+
+// Number of tile bytes stored for a map with the given layout
+static size_t binarySize(size_t columns, size_t rows, size_t chunkSize) {
+	if (chunkSize == 0) {
+		return columns * rows;
+	}
+	size_t chunkColumns = (columns + chunkSize - 1) / chunkSize;
+	size_t chunkRows = (rows + chunkSize - 1) / chunkSize;
+	return chunkColumns * chunkRows * chunkSize * chunkSize;
+}
+
+TileMap::TileMap() {
+	mTiles = NULL;
+	mMapping = NULL;
+	mMappingSize = 0;
+	mColumns = 0;
+	mRows = 0;
+	mTileWidth = TILE_WIDTH;
+	mTileHeight = TILE_HEIGHT;
+	mChunkSize = 0;
+}
+
+TileMap::~TileMap() {
+	free();
+}
+
+/**
+ * Read a whitespace separated list of tile types, row by row
+ * All tiles go into a single buffer sized up front
+ */
+bool TileMap::loadFromFile(std::string path, int columns, int rows) {
+	free();
+
+	if (columns < 0 || rows < 0 || !validDimensions(columns, rows, TILE_WIDTH, TILE_HEIGHT)) {
+		std::cout << "Invalid map size (" << columns << "x" << rows << ")\n";
+		return false;
+	}
+
+	std::ifstream map(path);
+	if (map.fail()) {
+		std::cout << "Unable to load file (" << path << ")\n";
+		return false;
+	}
+
+	mTypes.resize((size_t) columns * rows);
+	for (size_t i = 0; i < mTypes.size(); i++) {
+		int tileType = TILE_RED;
+		map >> tileType;
+		if (map.fail()) {
+			std::cout << "Error reading from file\n";
+			free();
+			return false;
+		}
+
+		if (tileType >= TILE_RED && tileType < TOTAL_TILE_SPRITES) {
+			mTypes[i] = tileType;
+		} else {
+			std::cout << "Invalid Tile Type at " << i << '\n';
+			free();
+			return false;
+		}
+	}
+
+	mTiles = mTypes.data();
+	mColumns = columns;
+	mRows = rows;
+	return true;
+}
+
+/**
+ * Memory map a binary map and use its tiles where they are
+ * Nothing is parsed or copied, the tile bytes are only scanned once to make
+ * sure every type can be drawn.
+ */
+bool TileMap::loadFromBinary(std::string path) {
+	free();
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		std::cout << "Unable to open map (" << path << "): " << strerror(errno) << '\n';
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(TileMapHeader)) {
+		std::cout << "Map too small to be valid (" << path << ")\n";
+		close(fd);
+		return false;
+	}
+
+	void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // Mapping stays valid after the descriptor is closed
+	if (mapping == MAP_FAILED) {
+		std::cout << "Unable to map file (" << path << "): " << strerror(errno) << '\n';
+		return false;
+	}
+	mMapping = mapping;
+	mMappingSize = info.st_size;
+
+	TileMapHeader header;
+	memcpy(&header, mapping, sizeof(header));
+	if (memcmp(header.magic, "LMAP", 4) != 0 || header.version != BINARY_VERSION) {
+		std::cout << "Not a supported binary map (" << path << ")\n";
+		free();
+		return false;
+	}
+	if (!validDimensions(header.columns, header.rows, header.tileWidth, header.tileHeight)) {
+		std::cout << "Invalid map size in binary map (" << path << ")\n";
+		free();
+		return false;
+	}
+	size_t tileCount = binarySize(header.columns, header.rows, header.chunkSize);
+	if (tileCount > mMappingSize - sizeof(header)) {
+		std::cout << "Binary map is truncated (" << path << ")\n";
+		free();
+		return false;
+	}
+
+	// Tile types index the clip array when rendering
+	const Uint8* tiles = static_cast<const Uint8*>(mapping) + sizeof(header);
+	for (size_t i = 0; i < tileCount; i++) {
+		if (tiles[i] >= TOTAL_TILE_SPRITES) {
+			std::cout << "Invalid Tile Type at " << i << '\n';
+			free();
+			return false;
+		}
+	}
+
+	mTiles = tiles;
+	mColumns = header.columns;
+	mRows = header.rows;
+	mTileWidth = header.tileWidth;
+	mTileHeight = header.tileHeight;
+	mChunkSize = header.chunkSize;
+	return true;
+}
+
+/**
+ * Write the loaded map in the binary format
+ * Used to convert text maps once so later loads can map them directly
+ */
+bool TileMap::saveBinary(std::string path, int chunkSize) {
+	if (mTiles == NULL || chunkSize < 0 || chunkSize > 0xffff) {
+		std::cout << "Nothing to save or invalid chunk size\n";
+		return false;
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (file.fail()) {
+		std::cout << "Unable to create file (" << path << ")\n";
+		return false;
+	}
+
+	TileMapHeader header = {{'L', 'M', 'A', 'P'}, BINARY_VERSION, (Uint16) chunkSize,
+													(Uint16) mTileWidth, (Uint16) mTileHeight,
+													(Uint32) mColumns, (Uint32) mRows};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	if (chunkSize == 0) {
+		for (int row = 0; row < mRows; row++) {
+			for (int col = 0; col < mColumns; col++) {
+				file.put(typeAt(col, row));
+			}
+		}
+	} else {
+		// Pad edge chunks with red tiles so every chunk has the same size
+		std::vector<char> chunk((size_t) chunkSize * chunkSize);
+		for (int chunkY = 0; chunkY < mRows; chunkY += chunkSize) {
+			for (int chunkX = 0; chunkX < mColumns; chunkX += chunkSize) {
+				std::fill(chunk.begin(), chunk.end(), TILE_RED);
+				for (int y = 0; y < chunkSize && chunkY + y < mRows; y++) {
+					for (int x = 0; x < chunkSize && chunkX + x < mColumns; x++) {
+						chunk[(size_t) y * chunkSize + x] = typeAt(chunkX + x, chunkY + y);
+					}
+				}
+				file.write(chunk.data(), chunk.size());
+			}
+		}
+	}
+
+	if (file.fail()) {
+		std::cout << "Error writing to file (" << path << ")\n";
+		return false;
+	}
+	return true;
+}
+
+void TileMap::free() {
+	// Swap with an empty buffer to actually release the memory
+	std::vector<Uint8>().swap(mTypes);
+
+	if (mMapping != NULL) {
+		munmap(mMapping, mMappingSize);
+		mMapping = NULL;
+		mMappingSize = 0;
+	}
+
+	mTiles = NULL;
+	mColumns = 0;
+	mRows = 0;
+	mTileWidth = TILE_WIDTH;
+	mTileHeight = TILE_HEIGHT;
+	mChunkSize = 0;
+}
+
+/**
+ * Work out which columns and rows the camera overlaps and only draw those
+ * The cost depends on the size of the camera instead of the size of the level
+ * and all tiles share a texture, so they go out in a single draw call
+ */
+void TileMap::render(SDL_Renderer* renderer, SDL_Rect& camera,
+										 LTexture* tileTexture, SDL_Rect* tileClips) {
+	int firstCol, lastCol, firstRow, lastRow;
+	getCellRange(camera, &firstCol, &lastCol, &firstRow, &lastRow);
+
+	for (int row = firstRow; row <= lastRow; row++) {
+		for (int col = firstCol; col <= lastCol; col++) {
+			mBatch.draw(renderer, tileTexture, col * mTileWidth - camera.x, row * mTileHeight - camera.y,
+									&tileClips[typeAt(col, row)]);
+		}
+	}
+	mBatch.flush(renderer);
+}
+
+// Check if given rectangle collides with any wall tiles
+// (Bottom left, center, top, top right, right, bottom right, bottom, left, top left)
+// Every cell in the range overlaps the box, so no further box test is needed
+bool TileMap::touchesWall(SDL_Rect& box) {
+	int firstCol, lastCol, firstRow, lastRow;
+	getCellRange(box, &firstCol, &lastCol, &firstRow, &lastRow);
+
+	for (int row = firstRow; row <= lastRow; row++) {
+		for (int col = firstCol; col <= lastCol; col++) {
+			Uint8 type = typeAt(col, row);
+			if (type >= TILE_CENTER && type <= TILE_TOPLEFT) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+TileTypes TileMap::getType(int index) {
+	return (TileTypes) typeAt(index % mColumns, index / mColumns);
+}
+
+// Boxes are not stored, they follow from the index
+SDL_Rect TileMap::getBox(int index) {
+	SDL_Rect box = {(index % mColumns) * mTileWidth, (index / mColumns) * mTileHeight,
+									mTileWidth, mTileHeight};
+	return box;
+}
+
+// Getters
+int TileMap::getColumns() {
+	return mColumns;
+}
+
+int TileMap::getRows() {
+	return mRows;
+}
+
+int TileMap::getTotalTiles() {
+	return mColumns * mRows;
+}
+
+int TileMap::getLevelWidth() {
+	return mColumns * mTileWidth;
+}
+
+int TileMap::getLevelHeight() {
+	return mRows * mTileHeight;
+}
+
+// Find the byte for a tile in either storage layout
+Uint8 TileMap::typeAt(int col, int row) {
+	if (mChunkSize == 0) {
+		return mTiles[(size_t) row * mColumns + col];
+	}
+	size_t chunkColumns = (mColumns + mChunkSize - 1) / mChunkSize;
+	size_t chunk = (row / mChunkSize) * chunkColumns + col / mChunkSize;
+	return mTiles[chunk * mChunkSize * mChunkSize + (row % mChunkSize) * mChunkSize +
+								col % mChunkSize];
+}
+
+// Clamp the cells under the rectangle to the map
+// An empty range (first > last) is returned when the rectangle is off the map
+void TileMap::getCellRange(SDL_Rect& box, int* firstCol, int* lastCol,
+													 int* firstRow, int* lastRow) {
+	*firstCol = std::max(floorDivide(box.x, mTileWidth), 0);
+	*lastCol = std::min(floorDivide(box.x + box.w - 1, mTileWidth), mColumns - 1);
+	*firstRow = std::max(floorDivide(box.y, mTileHeight), 0);
+	*lastRow = std::min(floorDivide(box.y + box.h - 1, mTileHeight), mRows - 1);
+}
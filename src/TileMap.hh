@@ -0,0 +1,86 @@
+#ifndef TILEMAP
+#define TILEMAP
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+#include "LTexture.hh"
+#include "LSpriteBatch.hh"
+#include "Tile.hh"
+
+// Start of a binary map, followed directly by the tile bytes
+// Row order maps store columns * rows bytes. Chunked maps store square
+// chunks row by row, each chunk holding its tiles row by row and padded to
+// the full chunk size at the edges of the map.
+struct TileMapHeader {
+	char magic[4]; // "LMAP"
+	Uint16 version;
+	Uint16 chunkSize;
+	Uint16 tileWidth;
+	Uint16 tileHeight;
+	Uint32 columns;
+	Uint32 rows;
+};
+
+// Grid of tiles stored as one byte per tile
+// A tile's position is implied by its index, so no per-tile boxes or
+// allocations are needed and any rectangle maps straight to the cells under it
+//
+// Tiles either come from a text map (row by row) or a binary map that is
+// memory mapped and read in place. Binary maps may store tiles in square
+// chunks so nearby tiles share pages.
+class TileMap {
+	public:
+		static const int BINARY_VERSION = 1;
+
+		TileMap();
+		~TileMap();
+
+		// mTiles points into the map's own storage, so copies would dangle
+		TileMap(const TileMap&) = delete;
+		TileMap& operator=(const TileMap&) = delete;
+
+		bool loadFromFile(std::string, int, int); // Path, columns, rows
+		bool loadFromBinary(std::string); // Map a converted file in place
+		bool saveBinary(std::string, int = 0); // Path, chunk size (0 keeps rows)
+		void free();
+
+		// Render only the tiles the camera can see
+		void render(SDL_Renderer*, SDL_Rect&, LTexture*, SDL_Rect*);
+
+		bool touchesWall(SDL_Rect&); // Check box against wall tiles under it
+
+		// Tile queries by index
+		TileTypes getType(int);
+		SDL_Rect getBox(int);
+
+		// Getters
+		int getColumns();
+		int getRows();
+		int getTotalTiles();
+		int getLevelWidth();
+		int getLevelHeight();
+
+	private:
+		std::vector<Uint8> mTypes; // Tiles read from a text map
+		const Uint8* mTiles; // Tiles in use, either mTypes or the mapped file
+
+		// Mapped binary file
+		void* mMapping;
+		size_t mMappingSize;
+
+		int mColumns;
+		int mRows;
+		int mTileWidth;
+		int mTileHeight;
+		int mChunkSize; // 0 when tiles are stored row by row
+
+		LSpriteBatch mBatch; // Visible tiles are drawn as one batch
+
+		Uint8 typeAt(int, int); // Type of tile at column, row
+
+		// Range of tile cells covered by the given rectangle
+		void getCellRange(SDL_Rect&, int*, int*, int*, int*);
+};
+#endif
@@ -9,13 +9,14 @@
 
 #include "LTexture.hh"
 #include "LTimer.hh"
+#include "LGlyphCache.hh"
 
 #define SCREEN_WIDTH (640)
 #define SCREEN_HEIGHT (480)
 
 bool init(SDL_Window**, SDL_Renderer**);
-bool loadMedia(LTexture*, SDL_Renderer*, TTF_Font**);
-void closeSDL(SDL_Window**, SDL_Renderer**, TTF_Font**, LTexture*, int);
+bool loadMedia(LTexture*, LGlyphCache*, SDL_Renderer*, TTF_Font**);
+void closeSDL(SDL_Window**, SDL_Renderer**, TTF_Font**, LTexture*, int, LGlyphCache*);
 
 // Initialize SDL, Window, Renderer, Image, and TTF
 bool init(SDL_Window** window, SDL_Renderer** renderer) {
@@ -57,7 +58,8 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
 	return true;
 }
 
-bool loadMedia(LTexture* texture, SDL_Renderer* renderer, TTF_Font** font_ptr) {
+bool loadMedia(LTexture* texture, LGlyphCache* glyphs, SDL_Renderer* renderer,
+							 TTF_Font** font_ptr) {
 	*font_ptr = TTF_OpenFont("fonts/lazy.ttf", 28);
 	if (*font_ptr == NULL) {
 		std::cout << "Failed to load lazy font: " << TTF_GetError() << '\n';
@@ -68,7 +70,6 @@ bool loadMedia(LTexture* texture, SDL_Renderer* renderer, TTF_Font** font_ptr) {
 
 	texture[0] = LTexture();
 	texture[1] = LTexture();
-	texture[2] = LTexture();
 
 	// Note make as few of these calls as possible
 	if (!texture[0].loadFromRenderedText("Press s to start and stop the timer.",
@@ -80,14 +81,20 @@ bool loadMedia(LTexture* texture, SDL_Renderer* renderer, TTF_Font** font_ptr) {
 																			 textColor, renderer, *font_ptr)) {
 		return false;
 	}
+
+	// Timer text changes every frame, so draw it from cached glyphs
+	if (!glyphs->build(*font_ptr, renderer)) {
+		return false;
+	}
 	return true;
 }
 
 void closeSDL(SDL_Window** window, SDL_Renderer** renderer, TTF_Font** font_ptr,
-							LTexture* textures, int numTextures) {
+							LTexture* textures, int numTextures, LGlyphCache* glyphs) {
 	for (int i = 0; i < numTextures; i++) {
 		textures[i].free();
 	}
+	glyphs->free();
 
 	TTF_CloseFont(*font_ptr);
 	*font_ptr = NULL;
@@ -107,12 +114,13 @@ int main(int argc, char** argv) {
 	SDL_Renderer* renderer = NULL;
 	TTF_Font* font = NULL;
 
-	LTexture textures[3];
+	LTexture textures[2];
+	LGlyphCache glyphs;
 
 	if (!init(&window, &renderer)) {
 		return -1;
 	}
-	if (!loadMedia(textures, renderer, &font)) {
+	if (!loadMedia(textures, &glyphs, renderer, &font)) {
 		return -1;
 	}
 
@@ -148,9 +156,6 @@ int main(int argc, char** argv) {
 		// Fill stream with next text
 		timeText << "Seconds since start time: " << timer.getTicks() / 1000;
 
-		textures[2].loadFromRenderedText(timeText.str().c_str(), text_color,
-																			 renderer, font);
-
 		SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
 		SDL_RenderClear(renderer);
 
@@ -158,12 +163,12 @@ int main(int argc, char** argv) {
 		textures[0].render(renderer, (SCREEN_WIDTH - textures[0].getWidth()) / 2, 0);
 		textures[1].render(renderer, (SCREEN_WIDTH - textures[1].getWidth()) / 2,
 											 textures[0].getHeight());
-		textures[2].render(renderer, (SCREEN_WIDTH - textures[0].getWidth()) / 2, 
-									 (SCREEN_HEIGHT - textures[2].getHeight()) / 2);
+		glyphs.renderText(renderer, (SCREEN_WIDTH - textures[0].getWidth()) / 2,
+											(SCREEN_HEIGHT - glyphs.getHeight()) / 2, timeText.str(), text_color);
 
 		SDL_RenderPresent(renderer);
 	}
 
-	closeSDL(&window, &renderer, &font, textures, 3);
+	closeSDL(&window, &renderer, &font, textures, 2, &glyphs);
 	return 0;
 }
@@ -0,0 +1,29 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "LTexture.hh"
+
+// Convert an image into the baked format read by LTexture::loadFromBaked
+// The color key is given as hex, e.g. ffffff for the dot (default 00ffff)
+// Usage: asset_bake <image> <baked image> [compress] [premultiply] [color key]
+int main(int argc, char** argv) {
+	if (argc < 3 || argc > 6) {
+		std::cout << "Usage: " << argv[0] << " <image> <baked image> [compress] [premultiply] [color key]\n";
+		return -1;
+	}
+
+	LTextureOptions options;
+	bool compress = argc > 3 && atoi(argv[3]) != 0;
+	options.premultiply = argc > 4 && atoi(argv[4]) != 0;
+	if (argc > 5) {
+		Uint32 key = strtoul(argv[5], NULL, 16);
+		options.key = {(Uint8) (key >> 16), (Uint8) (key >> 8), (Uint8) key, 0xff};
+	}
+
+	if (!LTexture::bakeImage(argv[1], argv[2], options, compress)) {
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,162 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LTexture.hh"
+#include "LAssetLoader.hh"
+#include "LPerfTimer.hh"
+
+#define SCREEN_WIDTH (640)
+#define SCREEN_HEIGHT (480)
+#define TOTAL_IMAGES (500)
+#define IMAGE_SIZE (256)
+
+// Loads 500 generated PNGs into textures with the software renderer, one
+// after another with LTexture::loadFromFile and through LAssetLoader with
+// one worker and with one worker per core
+// Usage: asset_load_bench
+
+bool init(SDL_Surface**, SDL_Renderer**);
+bool makeImages(std::vector<std::string>&);
+double timeLoader(int, std::vector<std::string>&, std::vector<LTexture>&, SDL_Renderer*);
+void closeSDL(SDL_Surface**, SDL_Renderer**, std::vector<std::string>&);
+
+// Render into a surface so no window or display is needed
+bool init(SDL_Surface** screen, SDL_Renderer** renderer) {
+	if (SDL_Init(0) < 0) {
+		std::cout << "Init Error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	*screen = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32,
+																					 SDL_PIXELFORMAT_ARGB8888);
+	if (*screen == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	*renderer = SDL_CreateSoftwareRenderer(*screen);
+	if (*renderer == NULL) {
+		std::cout << "Renderer creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	int imgFlags = IMG_INIT_PNG;
+	if (!(IMG_Init(imgFlags) & imgFlags)) {
+		std::cout << "SDL_Image init error: " << IMG_GetError() << '\n';
+		return false;
+	}
+	return true;
+}
+
+// Noisy blocks with a cyan border, so decoding has real work to do
+bool makeImages(std::vector<std::string>& paths) {
+	SDL_Surface* image = SDL_CreateRGBSurfaceWithFormat(0, IMAGE_SIZE, IMAGE_SIZE, 32,
+																											SDL_PIXELFORMAT_ARGB8888);
+	if (image == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	for (int i = 0; i < TOTAL_IMAGES; i++) {
+		SDL_FillRect(image, NULL, SDL_MapRGB(image->format, 0, 0xff, 0xff));
+		for (int y = 1; y < IMAGE_SIZE - 1; y += 5) {
+			for (int x = 1; x < IMAGE_SIZE - 1; x += 5) {
+				SDL_Rect block = {x, y, 5, 5};
+				SDL_FillRect(image, &block, SDL_MapRGB(image->format, rand() % 0x100,
+																							 rand() % 0x100, rand() % 0x100));
+			}
+		}
+
+		std::string path = "asset_load_bench_" + std::to_string(i) + ".png";
+		if (IMG_SavePNG(image, path.c_str()) != 0) {
+			std::cout << "Unable to write " << path << ": " << IMG_GetError() << '\n';
+			SDL_FreeSurface(image);
+			return false;
+		}
+		paths.push_back(path);
+	}
+
+	SDL_FreeSurface(image);
+	return true;
+}
+
+// Milliseconds to load every image through a loader, or -1 on failure
+double timeLoader(int threads, std::vector<std::string>& paths, std::vector<LTexture>& textures,
+									SDL_Renderer* renderer) {
+	LPerfTimer timer;
+	timer.start();
+
+	LAssetLoader loader(threads);
+	for (size_t i = 0; i < paths.size(); i++) {
+		loader.load(paths[i], &textures[i], renderer);
+	}
+	if (!loader.finish(renderer)) {
+		return -1;
+	}
+	return timer.getMilliseconds();
+}
+
+void closeSDL(SDL_Surface** screen, SDL_Renderer** renderer, std::vector<std::string>& paths) {
+	for (auto & path: paths) {
+		std::remove(path.c_str());
+	}
+
+	SDL_DestroyRenderer(*renderer);
+	*renderer = NULL;
+	SDL_FreeSurface(*screen);
+	*screen = NULL;
+
+	IMG_Quit();
+	SDL_Quit();
+}
+
+int main(int argc, char** argv) {
+	SDL_Surface* screen = NULL;
+	SDL_Renderer* renderer = NULL;
+	std::vector<std::string> paths;
+	std::vector<LTexture> textures(TOTAL_IMAGES);
+
+	srand(1);
+	if (!init(&screen, &renderer) || !makeImages(paths)) {
+		closeSDL(&screen, &renderer, paths);
+		return -1;
+	}
+
+	// The files were just written, so every run reads them from the page cache
+	LPerfTimer timer;
+	timer.start();
+	for (size_t i = 0; i < paths.size(); i++) {
+		if (!textures[i].loadFromFile(paths[i], renderer)) {
+			closeSDL(&screen, &renderer, paths);
+			return -1;
+		}
+	}
+	double directTime = timer.getMilliseconds();
+
+	int cores = std::max((int) std::thread::hardware_concurrency(), 1);
+	double singleTime = timeLoader(1, paths, textures, renderer);
+	double poolTime = timeLoader(cores, paths, textures, renderer);
+
+	for (auto & texture: textures) {
+		texture.free();
+	}
+	closeSDL(&screen, &renderer, paths);
+	if (singleTime < 0 || poolTime < 0) {
+		return -1;
+	}
+
+	std::cout << std::fixed << std::setprecision(1) << TOTAL_IMAGES << " PNGs of " << IMAGE_SIZE <<
+		"x" << IMAGE_SIZE << '\n' <<
+		"loadFromFile:              " << directTime << " ms\n" <<
+		"LAssetLoader, 1 worker:    " << singleTime << " ms\n" <<
+		"LAssetLoader, " << std::setw(2) << cores << " workers:  " << poolTime << " ms\n";
+	return 0;
+}
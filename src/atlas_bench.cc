@@ -0,0 +1,179 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "LTexture.hh"
+#include "LAtlas.hh"
+#include "LSpriteBatch.hh"
+#include "LPerfTimer.hh"
+
+#define SCREEN_WIDTH (640)
+#define SCREEN_HEIGHT (480)
+#define TOTAL_IMAGES (64)
+#define TOTAL_SPRITES (10000)
+#define FRAMES (100)
+
+// Draws 10k sprites of mixed images per frame with the software renderer:
+// each image in its own texture, then packed into an atlas, drawn one call
+// per sprite and through a sprite batch
+// Usage: atlas_bench
+
+struct SpriteDraw {
+	int image;
+	int x, y;
+};
+
+bool init(SDL_Surface**, SDL_Renderer**);
+bool makeImages(std::vector<std::string>&);
+void report(std::string, LPerfTimer&);
+void closeSDL(SDL_Surface**, SDL_Renderer**, std::vector<std::string>&);
+
+// Render into a surface so no window or display is needed
+bool init(SDL_Surface** screen, SDL_Renderer** renderer) {
+	if (SDL_Init(0) < 0) {
+		std::cout << "Init Error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+
+	*screen = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32,
+																					 SDL_PIXELFORMAT_ARGB8888);
+	if (*screen == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	*renderer = SDL_CreateSoftwareRenderer(*screen);
+	if (*renderer == NULL) {
+		std::cout << "Renderer creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	return true;
+}
+
+// Write images of different sizes and colors with a cyan border to key out
+bool makeImages(std::vector<std::string>& paths) {
+	for (int i = 0; i < TOTAL_IMAGES; i++) {
+		int w = 8 + rand() % 41;
+		int h = 8 + rand() % 41;
+		SDL_Surface* image = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+		if (image == NULL) {
+			std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+			return false;
+		}
+
+		SDL_FillRect(image, NULL, SDL_MapRGB(image->format, 0, 0xff, 0xff));
+		SDL_Rect inside = {1, 1, w - 2, h - 2};
+		SDL_FillRect(image, &inside, SDL_MapRGB(image->format, rand() % 0x100,
+																					 rand() % 0x100, rand() % 0x100));
+
+		std::string path = "atlas_bench_" + std::to_string(i) + ".bmp";
+		bool saved = SDL_SaveBMP(image, path.c_str()) == 0;
+		SDL_FreeSurface(image);
+		if (!saved) {
+			std::cout << "Unable to write " << path << ": " << SDL_GetError() << '\n';
+			return false;
+		}
+		paths.push_back(path);
+	}
+	return true;
+}
+
+void report(std::string name, LPerfTimer& timer) {
+	std::cout << std::fixed << std::setprecision(3) << std::setw(20) << std::left << name <<
+		" avg " << timer.getAverageLap() / 1000000 << " ms, min " <<
+		timer.getMinLap() / 1000000.0 << " ms per frame\n";
+}
+
+void closeSDL(SDL_Surface** screen, SDL_Renderer** renderer, std::vector<std::string>& paths) {
+	for (auto & path: paths) {
+		std::remove(path.c_str());
+	}
+
+	SDL_DestroyRenderer(*renderer);
+	*renderer = NULL;
+	SDL_FreeSurface(*screen);
+	*screen = NULL;
+
+	SDL_Quit();
+}
+
+int main(int argc, char** argv) {
+	SDL_Surface* screen = NULL;
+	SDL_Renderer* renderer = NULL;
+	std::vector<std::string> paths;
+
+	srand(1);
+	if (!init(&screen, &renderer) || !makeImages(paths)) {
+		return -1;
+	}
+
+	std::vector<LTexture> textures(TOTAL_IMAGES);
+	LAtlas atlas;
+	for (int i = 0; i < TOTAL_IMAGES; i++) {
+		if (!textures[i].loadFromFile(paths[i], renderer) || atlas.addFromFile(paths[i]) < 0) {
+			return -1;
+		}
+	}
+	if (!atlas.pack(renderer)) {
+		return -1;
+	}
+	std::cout << TOTAL_IMAGES << " images packed into " << atlas.getPageCount() << " page(s)\n";
+
+	// Same sprites for every run, in an order that keeps switching images
+	std::vector<SpriteDraw> draws(TOTAL_SPRITES);
+	for (auto & draw: draws) {
+		draw = {rand() % TOTAL_IMAGES, rand() % SCREEN_WIDTH, rand() % SCREEN_HEIGHT};
+	}
+
+	LPerfTimer textureTimer;
+	LPerfTimer atlasTimer;
+	LPerfTimer batchTimer;
+	LSpriteBatch batch;
+	for (int frame = 0; frame < FRAMES; frame++) {
+		// Separate textures, the texture changes on almost every draw
+		SDL_RenderClear(renderer);
+		textureTimer.start();
+		for (auto & draw: draws) {
+			textures[draw.image].render(renderer, draw.x, draw.y);
+		}
+		SDL_RenderPresent(renderer);
+		textureTimer.lap();
+
+		// Atlas sprites, consecutive copies share a page
+		SDL_RenderClear(renderer);
+		atlasTimer.start();
+		for (auto & draw: draws) {
+			atlas.getSprite(draw.image)->render(renderer, draw.x, draw.y);
+		}
+		SDL_RenderPresent(renderer);
+		atlasTimer.lap();
+
+		// Atlas sprites as geometry, one call per page
+		SDL_RenderClear(renderer);
+		batchTimer.start();
+		for (auto & draw: draws) {
+			batch.draw(renderer, atlas.getSprite(draw.image), draw.x, draw.y);
+		}
+		batch.flush(renderer);
+		SDL_RenderPresent(renderer);
+		batchTimer.lap();
+	}
+
+	std::cout << TOTAL_SPRITES << " sprites, " << FRAMES << " frames\n";
+	report("Separate textures", textureTimer);
+	report("Atlas", atlasTimer);
+	report("Atlas sprite batch", batchTimer);
+
+	for (auto & texture: textures) {
+		texture.free();
+	}
+	atlas.free();
+	closeSDL(&screen, &renderer, paths);
+	return 0;
+}
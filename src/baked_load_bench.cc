@@ -0,0 +1,169 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "LTexture.hh"
+#include "LPerfTimer.hh"
+
+#define SCREEN_WIDTH (640)
+#define SCREEN_HEIGHT (480)
+#define TOTAL_IMAGES (100)
+#define IMAGE_SIZE (512)
+
+// Loads 100 generated images into textures with the software renderer,
+// decoding the PNGs with LTexture::loadFromFile and mapping the same images
+// baked raw and LZ compressed with LTexture::loadFromBaked
+// Usage: baked_load_bench
+
+// Files made from each image: the PNG, its raw bake and its compressed bake
+static const char* suffixes[] = {".png", ".raw.limg", ".lz.limg"};
+
+bool init(SDL_Surface**, SDL_Renderer**);
+bool makeImages(std::vector<std::string>&);
+long fileSize(const std::string&);
+double timeLoads(std::vector<std::string>&, int, SDL_Renderer*);
+void closeSDL(SDL_Surface**, SDL_Renderer**, std::vector<std::string>&);
+
+// Render into a surface so no window or display is needed
+bool init(SDL_Surface** screen, SDL_Renderer** renderer) {
+	if (SDL_Init(0) < 0) {
+		std::cout << "Init Error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	*screen = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32,
+																					 SDL_PIXELFORMAT_ARGB8888);
+	if (*screen == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	*renderer = SDL_CreateSoftwareRenderer(*screen);
+	if (*renderer == NULL) {
+		std::cout << "Renderer creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	int imgFlags = IMG_INIT_PNG;
+	if (!(IMG_Init(imgFlags) & imgFlags)) {
+		std::cout << "SDL_Image init error: " << IMG_GetError() << '\n';
+		return false;
+	}
+	return true;
+}
+
+// Sprite sheet like images: flat colored blocks on a cyan background, baked
+// raw and compressed next to each PNG
+bool makeImages(std::vector<std::string>& paths) {
+	SDL_Surface* image = SDL_CreateRGBSurfaceWithFormat(0, IMAGE_SIZE, IMAGE_SIZE, 32,
+																											SDL_PIXELFORMAT_ARGB8888);
+	if (image == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	for (int i = 0; i < TOTAL_IMAGES; i++) {
+		SDL_FillRect(image, NULL, SDL_MapRGB(image->format, 0, 0xff, 0xff));
+		for (int y = 0; y < IMAGE_SIZE; y += 32) {
+			for (int x = 0; x < IMAGE_SIZE; x += 32) {
+				SDL_Rect block = {x + 2, y + 2, 28, 28};
+				SDL_FillRect(image, &block, SDL_MapRGB(image->format, rand() % 0x100,
+																							 rand() % 0x100, rand() % 0x100));
+			}
+		}
+
+		std::string path = "baked_load_bench_" + std::to_string(i);
+		if (IMG_SavePNG(image, (path + suffixes[0]).c_str()) != 0) {
+			std::cout << "Unable to write " << path << suffixes[0] << ": " << IMG_GetError() << '\n';
+			SDL_FreeSurface(image);
+			return false;
+		}
+		paths.push_back(path);
+		if (!LTexture::bakeImage(path + suffixes[0], path + suffixes[1]) ||
+				!LTexture::bakeImage(path + suffixes[0], path + suffixes[2], LTextureOptions(), true)) {
+			SDL_FreeSurface(image);
+			return false;
+		}
+	}
+
+	SDL_FreeSurface(image);
+	return true;
+}
+
+long fileSize(const std::string& path) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	return file.fail() ? 0 : (long) file.tellg();
+}
+
+// Milliseconds to load every image one way, or -1 on failure
+// kind indexes suffixes, so 0 decodes the PNGs and the others map bakes
+double timeLoads(std::vector<std::string>& paths, int kind, SDL_Renderer* renderer) {
+	LTexture texture;
+	LPerfTimer timer;
+	timer.start();
+	for (auto & path: paths) {
+		std::string file = path + suffixes[kind];
+		if (!(kind == 0 ? texture.loadFromFile(file, renderer) : texture.loadFromBaked(file, renderer))) {
+			return -1;
+		}
+	}
+	double time = timer.getMilliseconds();
+	texture.free();
+	return time;
+}
+
+void closeSDL(SDL_Surface** screen, SDL_Renderer** renderer, std::vector<std::string>& paths) {
+	for (auto & path: paths) {
+		for (auto & suffix: suffixes) {
+			std::remove((path + suffix).c_str());
+		}
+	}
+
+	SDL_DestroyRenderer(*renderer);
+	*renderer = NULL;
+	SDL_FreeSurface(*screen);
+	*screen = NULL;
+
+	IMG_Quit();
+	SDL_Quit();
+}
+
+int main(int argc, char** argv) {
+	SDL_Surface* screen = NULL;
+	SDL_Renderer* renderer = NULL;
+	std::vector<std::string> paths;
+
+	srand(1);
+	if (!init(&screen, &renderer) || !makeImages(paths)) {
+		closeSDL(&screen, &renderer, paths);
+		return -1;
+	}
+
+	// The files were just written, so every run reads them from the page cache
+	const char* names[] = {"PNG, loadFromFile:         ", "Baked raw, loadFromBaked:  ",
+												 "Baked LZ, loadFromBaked:   "};
+	double times[3];
+	long sizes[3];
+	for (int kind = 0; kind < 3; kind++) {
+		times[kind] = timeLoads(paths, kind, renderer);
+		sizes[kind] = fileSize(paths[0] + suffixes[kind]);
+	}
+
+	closeSDL(&screen, &renderer, paths);
+	if (times[0] < 0 || times[1] < 0 || times[2] < 0) {
+		return -1;
+	}
+
+	std::cout << std::fixed << std::setprecision(1) << TOTAL_IMAGES << " images of " << IMAGE_SIZE <<
+		"x" << IMAGE_SIZE << '\n';
+	for (int kind = 0; kind < 3; kind++) {
+		std::cout << names[kind] << times[kind] << " ms, " << sizes[kind] / 1024 << " KB per file\n";
+	}
+	return 0;
+}
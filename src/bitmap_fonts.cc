@@ -1,22 +1,48 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <string>
 
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "LTexture.hh"
+#include "LSpriteBatch.hh"
 
 #define SCREEN_WIDTH (640)
 #define SCREEN_HEIGHT (480)
 
 class LBitmapFont {
 	public:
+		static const Sint32 METRICS_VERSION = 2;
+
 		LBitmapFont();
 		bool buildFont(std::string, SDL_Window*, SDL_Renderer*);
 		void free();
 		void renderText(SDL_Renderer*, int, int, std::string);
 	
 	private:
+		// Start of the metrics file saved next to the font image, followed by the
+		// clip of each character
+		// Laid out without padding, so every byte written to the file is set
+		struct FontMetricsHeader {
+			char magic[4];
+			Sint32 version;
+			Sint64 imageTime; // Modification time of the image
+			Sint32 imageWidth;
+			Sint32 imageHeight;
+			Uint32 bgColor;
+			Sint32 newLine;
+			Sint32 space;
+			Sint32 unused; // Rounds the size up to a multiple of 8
+		};
+
 		LTexture mFontTexture;
+		LSpriteBatch mBatch; // Characters of a string are drawn as one batch
 
 		// Characters in surface
 		SDL_Rect mChars[256];
@@ -24,8 +50,63 @@ class LBitmapFont {
 		// Spacing
 		int mNewLine;
 		int mSpace;
+
+		void scanCells(Uint32); // Find character clips, given background color
+		bool loadMetrics(std::string, Uint32, Sint64);
+		void saveMetrics(std::string, Uint32, Sint64);
 };
 
+// Index of the first pixel in a run that is not the given color, or the run's
+// length if there is none. Four pixels are compared at a time with SSE2.
+static int firstDifferent(const Uint32* pixels, int count, Uint32 color) {
+	int i = 0;
+#ifdef __SSE2__
+	__m128i key = _mm_set1_epi32(color);
+	for (; i + 4 <= count; i += 4) {
+		__m128i block = _mm_loadu_si128((const __m128i*) (pixels + i));
+		int same = _mm_movemask_epi8(_mm_cmpeq_epi32(block, key));
+		if (same != 0xffff) {
+			return i + __builtin_ctz(~same) / 4;
+		}
+	}
+#endif
+	for (; i < count; i++) {
+		if (pixels[i] != color) {
+			return i;
+		}
+	}
+	return count;
+}
+
+// Index of the last pixel in a run that is not the given color, or -1
+static int lastDifferent(const Uint32* pixels, int count, Uint32 color) {
+	int i = count;
+#ifdef __SSE2__
+	__m128i key = _mm_set1_epi32(color);
+	for (; i >= 4; i -= 4) {
+		__m128i block = _mm_loadu_si128((const __m128i*) (pixels + i - 4));
+		int same = _mm_movemask_epi8(_mm_cmpeq_epi32(block, key));
+		if (same != 0xffff) {
+			return i - 4 + (31 - __builtin_clz(~same & 0xffff)) / 4;
+		}
+	}
+#endif
+	for (; i > 0; i--) {
+		if (pixels[i - 1] != color) {
+			return i - 1;
+		}
+	}
+	return -1;
+}
+
+static Sint64 getModifiedTime(std::string path) {
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0) {
+		return 0;
+	}
+	return info.st_mtime;
+}
+
 LBitmapFont::LBitmapFont() {
 	mNewLine = 0;
 	mSpace = 0;
@@ -37,6 +118,11 @@ void LBitmapFont::free() {
 	mSpace = 0;
 }
 
+/**
+ * Load the font sheet and find each character's clip
+ * Clips come from the metrics file next to the image when it is up to date,
+ * otherwise the sheet is scanned and the metrics file is written for next time
+ */
 bool LBitmapFont::buildFont(std::string path, SDL_Window* window, SDL_Renderer* renderer) {
 	free();
 
@@ -45,106 +131,144 @@ bool LBitmapFont::buildFont(std::string path, SDL_Window* window, SDL_Renderer*
 	}
 	Uint32 bgColor = mFontTexture.getPixel32(0, 0);
 
-	// Set dimentions
+	std::string metricsPath = path + ".metrics";
+	Sint64 imageTime = getModifiedTime(path);
+	if (!loadMetrics(metricsPath, bgColor, imageTime)) {
+		scanCells(bgColor);
+		saveMetrics(metricsPath, bgColor, imageTime);
+	}
+
+	if (!mFontTexture.loadFromPixels(renderer)) {
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Characters are arranged in a 16 by 16 grid of evenly sized cells, one per
+ * ASCII code. Every row of the sheet is read once, front to back, and each
+ * cell's segment of the row updates that cell's left, right, top and bottom
+ * bounds.
+ */
+void LBitmapFont::scanCells(Uint32 bgColor) {
 	int cellW = mFontTexture.getWidth() / 16;
 	int cellH = mFontTexture.getHeight() / 16;
+	Uint32* pixels = mFontTexture.getPixels32();
+	Uint32 pitch = mFontTexture.getPitch32();
 
-	// New line vars
-	int top = cellH;
-	int baseA = cellH;
-
-	int currChar = 0;
-
-	// Characters will be arranged in evenly divided cells each with an ASCII character
-	// We will iterate over the cells and set the clips for each cell
-	for (int rows = 0; rows < 16; rows++) {
-		for (int cols = 0; cols < 16; cols++) {
-			mChars[currChar].x = cellW * cols;
-			mChars[currChar].y = cellH * rows;
-			mChars[currChar].w = cellW;
-			mChars[currChar].h = cellH;
-			// Find left side
-			for (int pCol = 0; pCol < cellW; pCol++) {
-				for (int pRow = 0; pRow < cellH; pRow++) {
-					// Go through each pixel
-					int pX = (cellW * cols) + pCol;
-					int pY = (cellH * rows) + pRow;
-
-					// Non coler key pixel
-					if (mFontTexture.getPixel32(pX, pY) != bgColor) {
-						// Set x based on location of that pixel
-						mChars[currChar].x = pX;
-						// Escape loops
-						pCol = cellW;
-						pRow = cellH;
-					}
-				}
-			}
-			// Find right side
-			for (int pColW = cellW - 1; pColW >= 0; pColW--) {
-				for (int pRow = 0; pRow < cellH; pRow++) {
-					int pX = (cellW * cols) + pColW;
-					int pY = (cellH * rows) + pRow;
-					// Set width based on location of right pixel
-					if (mFontTexture.getPixel32(pX, pY) != bgColor) {
-						mChars[currChar].w = (pX - mChars[currChar].x) + 1;
-						pColW = -1;
-						pRow = cellH;
-					}
-				}
-			}
+	// Empty cells are left with left > right and top > bottom
+	int left[256], right[256], top[256], bottom[256];
+	for (int i = 0; i < 256; i++) {
+		left[i] = cellW;
+		right[i] = -1;
+		top[i] = cellH;
+		bottom[i] = -1;
+	}
 
-			// Find top
-			for (int pRow = 0; pRow < cellH; pRow++) {
-				for (int pCol = 0; pCol < cellW; pCol++) {
-					int pX = cellW * cols + pCol;
-					int pY = cellH * rows + pRow;
-
-					if (mFontTexture.getPixel32(pX, pY) != bgColor) {
-						// Set top to lower value when a lower top is found
-						if (pRow < top) {
-							top = pRow;
-						}
-						pCol = cellW;
-						pRow = cellH;
-					}
-				}
+	for (int pY = 0; pY < cellH * 16; pY++) {
+		Uint32* row = pixels + pY * pitch;
+		int pRow = pY % cellH;
+		int currChar = (pY / cellH) * 16;
+
+		for (int cols = 0; cols < 16; cols++, currChar++) {
+			Uint32* segment = row + cellW * cols;
+			int first = firstDifferent(segment, cellW, bgColor);
+			if (first == cellW) {
+				continue;
 			}
+			int last = first + lastDifferent(segment + first, cellW - first, bgColor);
 
-			// Find bottom of A
-			if (currChar == 'A') {
-				for (int pRow = cellH - 1; pRow >= 0; pRow--) {
-					for (int pCol = 0; pCol < cellW; pCol++) {
-						int pX = cellW * cols + pCol;
-						int pY = cellH * rows + pRow;
-						
-						if (mFontTexture.getPixel32(pX, pY) != bgColor) {
-							baseA = pRow;
-							pCol = cellW;
-							pRow = -1;
-						}
-					}
-				}
+			left[currChar] = std::min(left[currChar], first);
+			right[currChar] = std::max(right[currChar], last);
+			if (top[currChar] == cellH) {
+				top[currChar] = pRow;
 			}
-			currChar++;
+			bottom[currChar] = pRow;
 		}
 	}
 
-	mSpace = cellW / 2;
-	mNewLine = baseA - top;
+	// Highest pixel of any character and the bottom of A set the line spacing
+	int fontTop = cellH;
+	for (int i = 0; i < 256; i++) {
+		fontTop = std::min(fontTop, top[i]);
+	}
+	int baseA = bottom['A'] >= 0 ? bottom['A'] : cellH;
 
-	// Get rid of extra top pixels
 	for (int i = 0; i < 256; i++) {
-		mChars[i].y += top;
-		mChars[i].h -= top;
+		// Empty cells keep the full cell width
+		mChars[i].x = cellW * (i % 16);
+		mChars[i].w = cellW;
+		if (right[i] >= 0) {
+			mChars[i].x += left[i];
+			mChars[i].w = right[i] - left[i] + 1;
+		}
+
+		// Get rid of extra top pixels
+		mChars[i].y = cellH * (i / 16) + fontTop;
+		mChars[i].h = cellH - fontTop;
 	}
 
-	if (!mFontTexture.loadFromPixels(renderer)) {
+	mSpace = cellW / 2;
+	mNewLine = baseA - fontTop;
+}
+
+/**
+ * Read clips saved by an earlier scan
+ * The file is only used if it was made from the same image, size and
+ * background color, since the background depends on the window's format,
+ * and every clip lies within the image
+ */
+bool LBitmapFont::loadMetrics(std::string path, Uint32 bgColor, Sint64 imageTime) {
+	SDL_RWops* file = SDL_RWFromFile(path.c_str(), "rb");
+	if (file == NULL) {
+		return false;
+	}
+
+	FontMetricsHeader header;
+	SDL_Rect chars[256];
+	bool success = SDL_RWread(file, &header, sizeof(header), 1) == 1 &&
+		SDL_RWread(file, chars, sizeof(chars), 1) == 1;
+	SDL_RWclose(file);
+
+	if (!success || memcmp(header.magic, "LFNT", 4) != 0 ||
+			header.version != METRICS_VERSION || header.imageTime != imageTime ||
+			header.imageWidth != mFontTexture.getWidth() ||
+			header.imageHeight != mFontTexture.getHeight() || header.bgColor != bgColor ||
+			header.newLine < 0 || header.space < 0) {
 		return false;
 	}
+	for (int i = 0; i < 256; i++) {
+		if (chars[i].x < 0 || chars[i].y < 0 || chars[i].w < 0 || chars[i].h < 0 ||
+				chars[i].w > header.imageWidth - chars[i].x ||
+				chars[i].h > header.imageHeight - chars[i].y) {
+			return false;
+		}
+	}
+
+	memcpy(mChars, chars, sizeof(chars));
+	mNewLine = header.newLine;
+	mSpace = header.space;
 	return true;
 }
 
+// Failing to save only means the sheet is scanned again next time
+void LBitmapFont::saveMetrics(std::string path, Uint32 bgColor, Sint64 imageTime) {
+	FontMetricsHeader header = {{'L', 'F', 'N', 'T'}, METRICS_VERSION, imageTime,
+															mFontTexture.getWidth(), mFontTexture.getHeight(),
+															bgColor, mNewLine, mSpace, 0};
+
+	SDL_RWops* file = SDL_RWFromFile(path.c_str(), "wb");
+	if (file == NULL) {
+		std::cout << "Unable to save font metrics (" << path << "): " << SDL_GetError() << '\n';
+		return;
+	}
+	if (SDL_RWwrite(file, &header, sizeof(header), 1) != 1 ||
+			SDL_RWwrite(file, mChars, sizeof(mChars), 1) != 1) {
+		std::cout << "Unable to save font metrics (" << path << "): " << SDL_GetError() << '\n';
+	}
+	SDL_RWclose(file);
+}
+
 void LBitmapFont::renderText(SDL_Renderer* renderer, int x, int y, std::string text) {
 	if (mFontTexture.getWidth() > 0) {
 		int curX = x;
@@ -158,10 +282,11 @@ void LBitmapFont::renderText(SDL_Renderer* renderer, int x, int y, std::string t
 			} else { // Render the character
 				int ascii = (unsigned char) text[i];
 
-				mFontTexture.render(renderer, curX, curY, &mChars[ascii]);
+				mBatch.draw(renderer, &mFontTexture, curX, curY, &mChars[ascii]);
 				curX += mChars[ascii].w + 1;
 			}
 		}
+		mBatch.flush(renderer);
 	}
 }
 
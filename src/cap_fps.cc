@@ -5,20 +5,23 @@
 #include <sstream>
 #include <cstdio>
 #include <cmath>
+#include <iomanip>
 #include <iostream>
 
 #include "LTexture.hh"
-#include "LTimer.hh"
+#include "LPerfTimer.hh"
+#include "LFrameLimiter.hh"
+#include "LGlyphCache.hh"
+#include "LProfiler.hh"
 
 #define SCREEN_WIDTH (640)
 #define SCREEN_HEIGHT (480)
 #define SCREEN_FPS (60)
-// Milliseconds to wait before the next frame
-#define SCREEN_TICKS_PER_FRAME (1000 / SCREEN_FPS) 
+#define OVERLAY_FONT_SIZE (14)
 
 bool init(SDL_Window**, SDL_Renderer**);
-bool loadMedia(LTexture*, SDL_Renderer*, TTF_Font**);
-void closeSDL(SDL_Window**, SDL_Renderer**, TTF_Font**, LTexture*, int);
+bool loadMedia(LGlyphCache*, SDL_Renderer*, TTF_Font**, LGlyphCache*, TTF_Font**);
+void closeSDL(SDL_Window**, SDL_Renderer**, TTF_Font**, LGlyphCache*, TTF_Font**, LGlyphCache*);
 
 // Initialize SDL, Window, Renderer, Image, and TTF
 bool init(SDL_Window** window, SDL_Renderer** renderer) {
@@ -60,25 +63,40 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
 	return true;
 }
 
-bool loadMedia(LTexture* texture, SDL_Renderer* renderer, TTF_Font** font_ptr) {
+bool loadMedia(LGlyphCache* glyphs, SDL_Renderer* renderer, TTF_Font** font_ptr,
+							 LGlyphCache* overlayGlyphs, TTF_Font** overlayFont_ptr) {
 	*font_ptr = TTF_OpenFont("fonts/lazy.ttf", 28);
 	if (*font_ptr == NULL) {
 		std::cout << "Failed to load lazy font: " << TTF_GetError() << '\n';
 		return false;
 	}
 
-	*texture = LTexture();
+	// Rasterize the font once, the text changes every frame
+	if (!glyphs->build(*font_ptr, renderer)) {
+		return false;
+	}
+
+	// Smaller text for the profiler overlay
+	*overlayFont_ptr = TTF_OpenFont("fonts/lazy.ttf", OVERLAY_FONT_SIZE);
+	if (*overlayFont_ptr == NULL) {
+		std::cout << "Failed to load lazy font: " << TTF_GetError() << '\n';
+		return false;
+	}
+	if (!overlayGlyphs->build(*overlayFont_ptr, renderer)) {
+		return false;
+	}
 	return true;
 }
 
 void closeSDL(SDL_Window** window, SDL_Renderer** renderer, TTF_Font** font_ptr,
-							LTexture* textures, int numTextures) {
-	for (int i = 0; i < numTextures; i++) {
-		textures[i].free();
-	}
+							LGlyphCache* glyphs, TTF_Font** overlayFont_ptr, LGlyphCache* overlayGlyphs) {
+	glyphs->free();
+	overlayGlyphs->free();
 
 	TTF_CloseFont(*font_ptr);
 	*font_ptr = NULL;
+	TTF_CloseFont(*overlayFont_ptr);
+	*overlayFont_ptr = NULL;
 
 	SDL_DestroyRenderer(*renderer);
 	*renderer = NULL;
@@ -94,13 +112,15 @@ int main(int argc, char** argv) {
 	SDL_Window* window = NULL;
 	SDL_Renderer* renderer = NULL;
 	TTF_Font* font = NULL;
+	TTF_Font* overlayFont = NULL;
 
-	LTexture texture;
+	LGlyphCache glyphs;
+	LGlyphCache overlayGlyphs;
 
 	if (!init(&window, &renderer)) {
 		return -1;
 	}
-	if (!loadMedia(&texture, renderer, &font)) {
+	if (!loadMedia(&glyphs, renderer, &font, &overlayGlyphs, &overlayFont)) {
 		return -1;
 	}
 
@@ -109,49 +129,82 @@ int main(int argc, char** argv) {
 	SDL_Color text_color = {0, 0, 0, 0xff};
 
 	std::stringstream timeText;
-	LTimer fpsTimer = LTimer();
-	LTimer capTimer = LTimer();
+	std::stringstream frameText;
+	LPerfTimer fpsTimer; // Each frame is a lap
+	LFrameLimiter limiter(SCREEN_FPS);
 
 	int countedFrames = 0; // Keep track of number of frames renderered
 	fpsTimer.start(); // Keep track of time elapsed
 
+	// F1 toggles the overlay, F2 saves a trace of the last frames
+	LProfiler profiler;
+	bool showProfile = true;
+
 	while (!quit) {
-		capTimer.start(); // Count duration of current frame
-		while (SDL_PollEvent(&e) != 0) {
-			if (e.type == SDL_QUIT) {
-				quit = true;
-			} 		
+		profiler.beginFrame();
+		{
+			LProfileZone zone(&profiler, "Events");
+			while (SDL_PollEvent(&e) != 0) {
+				if (e.type == SDL_QUIT) {
+					quit = true;
+				} else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F1) {
+					showProfile = !showProfile;
+				} else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F2) {
+					profiler.writeTrace("cap_fps_trace.json");
+				}
+			}
 		}
 
-		// Frame rate calculations, number of frames / time passed
-		float avgFPS = countedFrames / (fpsTimer.getTicks() / 1000.f);
-		if (avgFPS > 2000000) {
-			avgFPS = 0;
-		}
+		{
+			LProfileZone zone(&profiler, "Update");
+
+			// Frame rate calculations, number of frames / time passed
+			float avgFPS = countedFrames / (fpsTimer.getMilliseconds() / 1000.f);
+			if (avgFPS > 2000000) {
+				avgFPS = 0;
+			}
 
-		timeText.str("");
-		timeText << "Average FPS: " << avgFPS;
+			timeText.str("");
+			timeText << "Average FPS: " << avgFPS;
 
-		texture.loadFromRenderedText(timeText.str().c_str(), text_color,
-																			 renderer, font);
+			// Frame times in milliseconds
+			frameText.str("");
+			frameText << std::fixed << std::setprecision(2) << "Frame: " <<
+				fpsTimer.getAverageLap() / 1000000 << " ms (" << fpsTimer.getMinLap() / 1000000.0 <<
+				" - " << fpsTimer.getMaxLap() / 1000000.0 << "), missed " << limiter.getMissed();
+		}
+
+		{
+			LProfileZone zone(&profiler, "Render");
+			SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
+			SDL_RenderClear(renderer);
 
-		SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
-		SDL_RenderClear(renderer);
+			// Render text centered
+			glyphs.renderText(renderer, (SCREEN_WIDTH - glyphs.getTextWidth(timeText.str())) / 2,
+												(SCREEN_HEIGHT - glyphs.getHeight()) / 2, timeText.str(), text_color);
+			glyphs.renderText(renderer, (SCREEN_WIDTH - glyphs.getTextWidth(frameText.str())) / 2,
+												(SCREEN_HEIGHT + glyphs.getHeight()) / 2, frameText.str(), text_color);
 
-		// Render text centered
-		texture.render(renderer, (SCREEN_WIDTH - texture.getWidth()) / 2, 
-									 (SCREEN_HEIGHT - texture.getHeight()) / 2);
+			if (showProfile) {
+				profiler.renderOverlay(renderer, &overlayGlyphs, 0, 0);
+			}
+		}
 
-		SDL_RenderPresent(renderer);
+		{
+			LProfileZone zone(&profiler, "Present");
+			SDL_RenderPresent(renderer);
+		}
 		countedFrames++;
 
-		// Stall as needed
-		int elapsedTicks = capTimer.getTicks();
-		if (elapsedTicks < SCREEN_TICKS_PER_FRAME) {
-			SDL_Delay(SCREEN_TICKS_PER_FRAME - elapsedTicks);
+		// Stall until the frame's deadline
+		{
+			LProfileZone zone(&profiler, "Wait");
+			limiter.wait();
 		}
+		fpsTimer.lap();
+		profiler.endFrame();
 	}
 
-	closeSDL(&window, &renderer, &font, &texture, 1);
+	closeSDL(&window, &renderer, &font, &glyphs, &overlayFont, &overlayGlyphs);
 	return 0;
 }
@@ -0,0 +1,297 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "Collision.hh"
+#include "MultiRectCollider.hh"
+#include "LPerfTimer.hh"
+
+#define WORLD_SIZE (2000)
+#define MAX_RADIUS (100)
+#define MAX_RECT_SIZE (200)
+#define TOTAL_SHAPES (10003)
+#define REPEATS (200)
+#define EDGE_RANGE (6)
+
+// Checks the single collision checks in Collision.hh against the functions
+// they replaced, on random shapes and on every small shape around a fixed one
+// so edges and corners that exactly touch are covered. Then checks the batch
+// checks against the single ones on random shapes, for every count up to 16
+// and one that is not a multiple of four, and times both over 10003 shapes
+// Usage: collision_batch_bench
+
+// The checks as they were in Dot.cc and per-pix_collision.cc before
+// Collision.hh, kept as they were written
+namespace reference {
+	double distanceSquared(int, int, int, int);
+
+	bool checkCollision(Circle& a, Circle& b) {
+		int rSquared = a.r + b.r;
+		rSquared *= rSquared;
+
+		// Check if circles have collided
+		if (distanceSquared(a.x, a.y, b.x, b.y) < rSquared) {
+			return true;
+		}
+
+		return false;
+	}
+
+	bool checkCollision(Circle& a, SDL_Rect& b) {
+		// Find closed point on the box to the circle
+		int cX;
+		int cY;
+
+		// Figure out which side of the box the circle is closest to
+		if (a.x < b.x) {
+			cX = b.x;
+		} else if (a.x > b.x + b.w) {
+			cX = b.x + b.w;
+		} else {
+			cX = a.x;
+		}
+
+		if (a.y < b.y) {
+			cY = b.y;
+		} else if (a.y > b.y + b.h) {
+			cY = b.y + b.h;
+		} else {
+			cY = a.y;
+		}
+
+		// Check if they collide
+		if (distanceSquared(a.x, a.y, cX, cY) < a.r * a.r) {
+			return true;
+		}
+
+		return false;
+	}
+
+	double distanceSquared(int x1, int y1, int x2, int y2) {
+		int dX = x2 - x1;
+		int dY = y2 - y1;
+		return dX * dX + dY * dY;
+	}
+
+	bool checkCollision(std::vector<SDL_Rect> a_rects, std::vector<SDL_Rect> b_rects) {
+		for (auto & a: a_rects) {
+			int rightA = a.x + a.w;
+			int bottomA = a.y + a.h;
+			for (auto & b: b_rects) {
+				int rightB = b.x + b.w;
+				int bottomB = b.y + b.h;
+
+				// Check if any side is inside of the collision 
+				// Opposite of previous lesson incase we can finish early
+				if (!(bottomA <= b.y || a.y >= bottomB || rightA <= b.x || rightB <= a.x)) {
+					return true;
+				}
+			}
+		}
+		return false; // No collision
+	}
+}
+
+Circle randomCircle();
+SDL_Rect randomRect();
+MultiRectCollider randomCollider();
+int checkShapes(Circle, Circle, SDL_Rect, SDL_Rect);
+int checkColliders(MultiRectCollider&, MultiRectCollider&);
+int checkReferences();
+int checkEdges();
+int checkBatches(std::vector<Circle>&, std::vector<SDL_Rect>&, size_t);
+
+Circle randomCircle() {
+	return {rand() % WORLD_SIZE, rand() % WORLD_SIZE, rand() % MAX_RADIUS};
+}
+
+SDL_Rect randomRect() {
+	return {rand() % WORLD_SIZE, rand() % WORLD_SIZE, rand() % MAX_RECT_SIZE, rand() % MAX_RECT_SIZE};
+}
+
+// A few rects around the origin, placed at random
+MultiRectCollider randomCollider() {
+	MultiRectCollider collider;
+	int rects = rand() % 4 + 1;
+	for (int i = 0; i < rects; i++) {
+		collider.addRect(rand() % MAX_RECT_SIZE, rand() % MAX_RECT_SIZE, rand() % MAX_RECT_SIZE,
+										 rand() % MAX_RECT_SIZE);
+	}
+	collider.setPosition(rand() % WORLD_SIZE, rand() % WORLD_SIZE);
+	return collider;
+}
+
+// Mismatches between the single checks and the old functions for a pair of
+// circles, the first circle and the second rect, and a pair of rects
+int checkShapes(Circle circleA, Circle circleB, SDL_Rect rectA, SDL_Rect rectB) {
+	int mismatches = 0;
+	mismatches += circlesCollide(circleA, circleB) != reference::checkCollision(circleA, circleB);
+	mismatches += circleCollidesRect(circleA, rectB) != reference::checkCollision(circleA, rectB);
+	mismatches += rectsCollide(rectA, rectB) != reference::checkCollision({rectA}, {rectB});
+	return mismatches;
+}
+
+int checkColliders(MultiRectCollider& a, MultiRectCollider& b) {
+	return multiRectsCollide(a, b) != reference::checkCollision(a.getRects(), b.getRects());
+}
+
+int checkReferences() {
+	int mismatches = 0;
+	for (int test = 0; test < 100000; test++) {
+		mismatches += checkShapes(randomCircle(), randomCircle(), randomRect(), randomRect());
+	}
+	for (int test = 0; test < 10000; test++) {
+		MultiRectCollider a = randomCollider();
+		MultiRectCollider b = randomCollider();
+		mismatches += checkColliders(a, b);
+	}
+	return mismatches;
+}
+
+/**
+ * Every small shape with its position in -EDGE_RANGE..EDGE_RANGE against
+ * shapes at the origin, which covers circles exactly touching each other or
+ * a rect's edge or corner, and rects sharing an edge or a corner
+ */
+int checkEdges() {
+	int mismatches = 0;
+	for (int size = 0; size <= 4; size++) {
+		Circle fixedCircle = {0, 0, size};
+		SDL_Rect fixedRect = {0, 0, size, size + 1};
+		MultiRectCollider fixedCollider;
+		fixedCollider.addRect(0, 0, size, 1);
+		fixedCollider.addRect(0, 1, 1, size);
+		fixedCollider.setPosition(0, 0);
+
+		for (int y = -EDGE_RANGE; y <= EDGE_RANGE; y++) {
+			for (int x = -EDGE_RANGE; x <= EDGE_RANGE; x++) {
+				for (int other = 0; other <= 4; other++) {
+					Circle circle = {x, y, other};
+					SDL_Rect rect = {x, y, other, 4 - other};
+					mismatches += checkShapes(circle, fixedCircle, rect, fixedRect);
+					mismatches += checkShapes(fixedCircle, circle, fixedRect, rect);
+
+					MultiRectCollider collider;
+					collider.addRect(0, 0, other, 2);
+					collider.addRect(2, 2, 2, other);
+					collider.setPosition(x, y);
+					mismatches += checkColliders(collider, fixedCollider);
+					mismatches += checkColliders(fixedCollider, collider);
+				}
+			}
+		}
+	}
+	return mismatches;
+}
+
+// Mismatches between the batch and single checks over the first count shapes,
+// for a few random shapes checked against them
+int checkBatches(std::vector<Circle>& circles, std::vector<SDL_Rect>& rects, size_t count) {
+	std::vector<Uint8> hits(count);
+	int mismatches = 0;
+	for (int test = 0; test < 100; test++) {
+		Circle circle = randomCircle();
+		SDL_Rect rect = randomRect();
+
+		size_t hitCount = circleHits(circle, circles.data(), count, hits.data());
+		size_t expected = 0;
+		for (size_t i = 0; i < count; i++) {
+			expected += circlesCollide(circle, circles[i]);
+			mismatches += hits[i] != circlesCollide(circle, circles[i]);
+		}
+		mismatches += hitCount != expected;
+
+		hitCount = circleRectHits(circle, rects.data(), count, hits.data());
+		expected = 0;
+		for (size_t i = 0; i < count; i++) {
+			expected += circleCollidesRect(circle, rects[i]);
+			mismatches += hits[i] != circleCollidesRect(circle, rects[i]);
+		}
+		mismatches += hitCount != expected;
+
+		hitCount = rectHits(rect, rects.data(), count, hits.data());
+		expected = 0;
+		for (size_t i = 0; i < count; i++) {
+			expected += rectsCollide(rect, rects[i]);
+			mismatches += hits[i] != rectsCollide(rect, rects[i]);
+		}
+		mismatches += hitCount != expected;
+	}
+	return mismatches;
+}
+
+int main(int argc, char** argv) {
+	srand(1);
+	std::vector<Circle> circles(TOTAL_SHAPES);
+	std::vector<SDL_Rect> rects(TOTAL_SHAPES);
+	for (int i = 0; i < TOTAL_SHAPES; i++) {
+		circles[i] = randomCircle();
+		rects[i] = randomRect();
+	}
+
+	int mismatches = checkReferences() + checkEdges();
+	if (mismatches != 0) {
+		std::cout << mismatches << " results differed from the old checks\n";
+		return -1;
+	}
+
+	mismatches = checkBatches(circles, rects, TOTAL_SHAPES);
+	for (size_t count = 0; count <= 16; count++) {
+		mismatches += checkBatches(circles, rects, count);
+	}
+	if (mismatches != 0) {
+		std::cout << mismatches << " batch results differed from the single checks\n";
+		return -1;
+	}
+
+	// Each timed loop sums its hits, so none of the checks can be skipped
+	std::vector<Uint8> hits(TOTAL_SHAPES);
+	Circle circle = {WORLD_SIZE / 2, WORLD_SIZE / 2, MAX_RADIUS};
+	SDL_Rect rect = {WORLD_SIZE / 2, WORLD_SIZE / 2, MAX_RECT_SIZE, MAX_RECT_SIZE};
+	LPerfTimer timers[6];
+	size_t totals[6] = {};
+	for (int repeat = 0; repeat < REPEATS; repeat++) {
+		timers[0].start();
+		for (auto & other: circles) {
+			totals[0] += circlesCollide(circle, other);
+		}
+		timers[0].lap();
+		timers[1].start();
+		totals[1] += circleHits(circle, circles.data(), TOTAL_SHAPES, hits.data());
+		timers[1].lap();
+
+		timers[2].start();
+		for (auto & other: rects) {
+			totals[2] += circleCollidesRect(circle, other);
+		}
+		timers[2].lap();
+		timers[3].start();
+		totals[3] += circleRectHits(circle, rects.data(), TOTAL_SHAPES, hits.data());
+		timers[3].lap();
+
+		timers[4].start();
+		for (auto & other: rects) {
+			totals[4] += rectsCollide(rect, other);
+		}
+		timers[4].lap();
+		timers[5].start();
+		totals[5] += rectHits(rect, rects.data(), TOTAL_SHAPES, hits.data());
+		timers[5].lap();
+	}
+
+	const char* names[] = {"Circle vs circles: ", "Circle vs rects:   ", "Rect vs rects:     "};
+	std::cout << std::fixed << std::setprecision(2) <<
+		"All results matched the old checks and the batches, ns per shape over " <<
+		TOTAL_SHAPES << " shapes\n";
+	for (int check = 0; check < 3; check++) {
+		std::cout << names[check] << "single " << timers[check * 2].getAverageLap() / TOTAL_SHAPES <<
+			", batch " << timers[check * 2 + 1].getAverageLap() / TOTAL_SHAPES << " (" <<
+			totals[check * 2 + 1] / REPEATS << " hits)\n";
+		if (totals[check * 2] != totals[check * 2 + 1]) {
+			return -1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,119 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "CollisionWorld.hh"
+#include "Dot.hh"
+#include "MultiRectCollider.hh"
+#include "LPerfTimer.hh"
+
+#define TOTAL_DOTS (10000)
+#define AREA_PER_DOT (40 * 40)
+#define FRAMES (60)
+#define CHECK_EVERY (10)
+
+// Moves 10k dot colliders around a square world, finding the overlapping
+// pairs each frame with a CollisionWorld, and checks the pairs against
+// testing every pair of dots every few frames. The world grows with the
+// number of dots, so each has AREA_PER_DOT of room whatever the count.
+// Usage: collision_bench
+
+struct MovingDot {
+	int x, y;
+	int velX, velY;
+};
+
+void bruteForcePairs(std::vector<MultiRectCollider>&, std::vector<std::pair<int, int>>&);
+
+// Every pair of dots whose bounds overlap or touch, as the world boxes them
+void bruteForcePairs(std::vector<MultiRectCollider>& colliders,
+										 std::vector<std::pair<int, int>>& pairs) {
+	pairs.clear();
+	for (size_t i = 0; i < colliders.size(); i++) {
+		const SDL_Rect& a = colliders[i].getBounds();
+		for (size_t j = i + 1; j < colliders.size(); j++) {
+			const SDL_Rect& b = colliders[j].getBounds();
+			if (a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h) {
+				pairs.emplace_back(i, j);
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	int worldSize = std::sqrt((double) TOTAL_DOTS * AREA_PER_DOT);
+	int maxX = worldSize - Dot::DOT_WIDTH;
+	int maxY = worldSize - Dot::DOT_HEIGHT;
+
+	// Each dot has the per-pixel colliders of a Dot and moves at up to a Dot's
+	// speed on each axis, bouncing off the edges of the world
+	srand(1);
+	MultiRectCollider shape = Dot(0, 0).getColliders();
+	std::vector<MultiRectCollider> colliders(TOTAL_DOTS, shape);
+	std::vector<MovingDot> dots(TOTAL_DOTS);
+	for (int i = 0; i < TOTAL_DOTS; i++) {
+		dots[i] = {rand() % maxX, rand() % maxY, rand() % (2 * Dot::DOT_VEL + 1) - Dot::DOT_VEL,
+							 rand() % (2 * Dot::DOT_VEL + 1) - Dot::DOT_VEL};
+		colliders[i].setPosition(dots[i].x, dots[i].y);
+	}
+
+	// The dots are never added or removed, so each body's id is its index
+	CollisionWorld world;
+	for (auto & collider: colliders) {
+		world.addBody(&collider);
+	}
+
+	LPerfTimer worldTimer;
+	LPerfTimer bruteTimer;
+	std::vector<std::pair<int, int>> expected;
+	size_t totalPairs = 0;
+	int mismatches = 0;
+	for (int frame = 0; frame < FRAMES; frame++) {
+		for (int i = 0; i < TOTAL_DOTS; i++) {
+			MovingDot& dot = dots[i];
+			dot.x += dot.velX;
+			if (dot.x < 0 || dot.x > maxX) {
+				dot.velX = -dot.velX;
+				dot.x = std::min(std::max(dot.x, 0), maxX);
+			}
+			dot.y += dot.velY;
+			if (dot.y < 0 || dot.y > maxY) {
+				dot.velY = -dot.velY;
+				dot.y = std::min(std::max(dot.y, 0), maxY);
+			}
+			colliders[i].setPosition(dot.x, dot.y);
+		}
+
+		worldTimer.start();
+		world.update();
+		worldTimer.lap();
+		totalPairs += world.getPairs().size();
+
+		if (frame % CHECK_EVERY == 0) {
+			bruteTimer.start();
+			bruteForcePairs(colliders, expected);
+			bruteTimer.lap();
+
+			std::vector<std::pair<int, int>> pairs = world.getPairs();
+			std::sort(pairs.begin(), pairs.end());
+			if (pairs != expected) {
+				std::cout << "Frame " << frame << ": world found " << pairs.size() << " pairs, every pair " <<
+					expected.size() << '\n';
+				mismatches++;
+			}
+		}
+	}
+
+	std::cout << std::fixed << std::setprecision(3) << TOTAL_DOTS << " dots in " << worldSize <<
+		"x" << worldSize << ", " << totalPairs / FRAMES << " pairs per frame on average\n" <<
+		"CollisionWorld::update: " << worldTimer.getAverageLap() / 1000000 << " ms per frame\n" <<
+		"Every pair:             " << bruteTimer.getAverageLap() / 1000000 << " ms per frame\n" <<
+		(mismatches == 0 ? "Pairs matched" : "Pairs differed") << " on " << FRAMES / CHECK_EVERY <<
+		" checked frames\n";
+	return mismatches == 0 ? 0 : -1;
+}
@@ -0,0 +1,133 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "LTexture.hh"
+#include "LPerfTimer.hh"
+
+#define SCREEN_WIDTH (640)
+#define SCREEN_HEIGHT (480)
+#define FRAME_WIDTH (1280)
+#define FRAME_HEIGHT (720)
+#define CELL_SIZE (16)
+#define FRAMES (60)
+
+// Changes a growing share of a 1280x720 frame in 16x16 cells and uploads it
+// to a streaming texture with the software renderer, through markDirty and
+// updateDirty and as a whole frame copy into the locked texture
+// Usage: dirty_bench
+
+bool init(SDL_Surface**, SDL_Renderer**);
+void closeSDL(SDL_Surface**, SDL_Renderer**);
+
+// Render into a surface so no window or display is needed
+bool init(SDL_Surface** screen, SDL_Renderer** renderer) {
+	if (SDL_Init(0) < 0) {
+		std::cout << "Init Error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	*screen = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32,
+																					 SDL_PIXELFORMAT_ARGB8888);
+	if (*screen == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	*renderer = SDL_CreateSoftwareRenderer(*screen);
+	if (*renderer == NULL) {
+		std::cout << "Renderer creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	return true;
+}
+
+void closeSDL(SDL_Surface** screen, SDL_Renderer** renderer) {
+	SDL_DestroyRenderer(*renderer);
+	*renderer = NULL;
+	SDL_FreeSurface(*screen);
+	*screen = NULL;
+
+	SDL_Quit();
+}
+
+int main(int argc, char** argv) {
+	SDL_Surface* screen = NULL;
+	SDL_Renderer* renderer = NULL;
+	LTexture texture;
+	const int percents[] = {1, 5, 10, 25, 50, 100};
+
+	if (!init(&screen, &renderer) ||
+			!texture.createBlank(FRAME_WIDTH, FRAME_HEIGHT, SDL_TEXTUREACCESS_STREAMING, renderer)) {
+		return -1;
+	}
+
+	// Frame kept by the caller in the texture's format
+	int pitch = FRAME_WIDTH * 4;
+	std::vector<Uint32> frame((size_t) FRAME_WIDTH * FRAME_HEIGHT);
+
+	int columns = FRAME_WIDTH / CELL_SIZE;
+	std::vector<int> cells(columns * (FRAME_HEIGHT / CELL_SIZE));
+	for (size_t i = 0; i < cells.size(); i++) {
+		cells[i] = i;
+	}
+	std::mt19937 random(1);
+
+	std::cout << std::fixed << std::setprecision(3) << FRAME_WIDTH << "x" << FRAME_HEIGHT <<
+		" frame, " << CELL_SIZE << "x" << CELL_SIZE << " cells, ms per frame over " << FRAMES <<
+		" frames\n";
+	for (int percent: percents) {
+		size_t changed = cells.size() * percent / 100;
+		LPerfTimer dirtyTimer;
+		LPerfTimer fullTimer;
+		for (int i = 0; i < FRAMES; i++) {
+			// Different cells every frame, each changed once
+			std::shuffle(cells.begin(), cells.end(), random);
+			Uint32 color = random();
+			for (size_t c = 0; c < changed; c++) {
+				int x = cells[c] % columns * CELL_SIZE;
+				int y = cells[c] / columns * CELL_SIZE;
+				for (int row = y; row < y + CELL_SIZE; row++) {
+					std::fill_n(&frame[(size_t) row * FRAME_WIDTH + x], CELL_SIZE, color);
+				}
+			}
+
+			dirtyTimer.start();
+			for (size_t c = 0; c < changed; c++) {
+				texture.markDirty({cells[c] % columns * CELL_SIZE, cells[c] / columns * CELL_SIZE,
+													 CELL_SIZE, CELL_SIZE});
+			}
+			if (!texture.updateDirty(frame.data(), pitch)) {
+				return -1;
+			}
+			dirtyTimer.lap();
+
+			fullTimer.start();
+			if (!texture.lockTexture()) {
+				return -1;
+			}
+			texture.copyRawPixels32(frame.data(), pitch);
+			texture.unlockTexture();
+			fullTimer.lap();
+		}
+
+		// Cells never overlap, so the dirty upload is exactly the changed cells
+		// until updateDirty switches to uploading the whole frame
+		double frameBytes = (double) pitch * FRAME_HEIGHT;
+		double dirtyBytes = (double) changed * CELL_SIZE * CELL_SIZE * 4;
+		if (dirtyBytes >= LTexture::FULL_UPDATE_SHARE * frameBytes) {
+			dirtyBytes = frameBytes;
+		}
+		std::cout << std::setw(3) << percent << "% changed: updateDirty " <<
+			dirtyTimer.getAverageLap() / 1000000 << " (" << dirtyBytes / 1048576 << " MB), full copy " <<
+			fullTimer.getAverageLap() / 1000000 << " (" << frameBytes / 1048576 << " MB)\n";
+	}
+
+	texture.free();
+	closeSDL(&screen, &renderer);
+	return 0;
+}
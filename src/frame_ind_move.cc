@@ -5,11 +5,12 @@
 #include <sstream>
 #include <cstdio>
 #include <cmath>
+#include <vector>
 #include <iostream>
 
 #include "LTexture.hh"
 #include "Dot.hh"
-#include "LTimer.hh"
+#include "LGameLoop.hh"
 
 #define SCREEN_WIDTH (640)
 #define SCREEN_HEIGHT (480)
@@ -61,7 +62,10 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
 
 bool loadMedia(LTexture* texture, SDL_Renderer* renderer) {
 	*texture = LTexture();
-	if (!texture->loadFromFile("images/dot.bmp", renderer)) {
+	// Dot has a white background
+	LTextureOptions dotOptions;
+	dotOptions.key = {0xff, 0xff, 0xff, 0xff};
+	if (!texture->loadFromFile("images/dot.bmp", renderer, dotOptions)) {
 		return false;
 	}
 
@@ -100,7 +104,13 @@ int main(int argc, char** argv) {
 	SDL_Event e;
 	bool quit = false;
 	Dot dot;
-	LTimer stepTimer;
+
+	// Thinner than a tick's step, sweeping keeps the dot from skipping over it
+	std::vector<SDL_Rect> walls = {{300, 40, 4, 400}};
+
+	// Simulate at a fixed rate, rendering at whatever rate the display runs
+	LGameLoop loop;
+	loop.start();
 	while (!quit) {
 		while (SDL_PollEvent(&e) != 0) {
 			if (e.type == SDL_QUIT) {
@@ -108,16 +118,21 @@ int main(int argc, char** argv) {
 			}
 			dot.handleEvent(e);
 		}
-		// Move based on calculated time step
-		dot.move(stepTimer.getTicks() / 1000.f);
-
-		// Reset timer
-		stepTimer.start();
+		// Move by the same time step however long the frame took
+		int ticks = loop.advance();
+		for (int i = 0; i < ticks; i++) {
+			dot.move(loop.getTickTime(), walls);
+		}
 
 		SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
 		SDL_RenderClear(renderer);
+
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0xff);
+		for (auto & wall: walls) {
+			SDL_RenderDrawRect(renderer, &wall); // Draw wall
+		}
 	
-		dot.render(renderer, &texture);
+		dot.render(renderer, &texture, loop.getAlpha());
 
 		SDL_RenderPresent(renderer);
 	}
@@ -61,7 +61,10 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
 
 bool loadMedia(LTexture* textures, SDL_Renderer* renderer) {
 	textures[0] = LTexture();
-	if (!textures[0].loadFromFile("images/dot.bmp", renderer)) {
+	// Dot has a white background
+	LTextureOptions dotOptions;
+	dotOptions.key = {0xff, 0xff, 0xff, 0xff};
+	if (!textures[0].loadFromFile("images/dot.bmp", renderer, dotOptions)) {
 		return false;
 	}
 
@@ -5,6 +5,7 @@
 #include <iostream>
 
 #include "LTexture.hh"
+#include "LAtlas.hh"
 
 #define SCREEN_WIDTH (640)
 #define SCREEN_HEIGHT (480)
@@ -20,8 +21,8 @@ enum texture_options {
 
 // Function declarations
 bool init(SDL_Window**, SDL_Renderer**);
-bool loadMedia(LTexture*, SDL_Renderer*);
-void closeSDL(SDL_Window**, SDL_Renderer**, LTexture*, int);
+bool loadMedia(LAtlas*, SDL_Renderer*);
+void closeSDL(SDL_Window**, SDL_Renderer**, LAtlas*);
 
 // Initialize SDL, Window, Renderer, and Image
 bool init(SDL_Window** window, SDL_Renderer** renderer) {
@@ -58,35 +59,23 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
 	return true;
 }
 
-// Load image into texture object
-bool loadMedia(LTexture* textures, SDL_Renderer* renderer) {
+// Pack all images into one atlas so they share a texture
+// Sprite ids follow the order they are added in, matching texture_options
+bool loadMedia(LAtlas* atlas, SDL_Renderer* renderer) {
+	std::string paths[TOTAL] = {"images/up.png", "images/down.png", "images/left.png",
+															"images/right.png", "images/press.png"};
 	for (int i = 0; i < TOTAL; i++) {
-		textures[i] = LTexture();
-	}
-	if (!textures[UP].loadFromFile("images/up.png", renderer)) {
-		return false;
-	}
-	if (!textures[DOWN].loadFromFile("images/down.png", renderer)) {
-		return false;
-	}
-	if (!textures[LEFT].loadFromFile("images/left.png", renderer)) {
-		return false;
-	}
-	if (!textures[RIGHT].loadFromFile("images/right.png", renderer)) {
-		return false;
-	}
-	if (!textures[PRESS].loadFromFile("images/press.png", renderer)) {
-		return false;
+		if (atlas->addFromFile(paths[i]) != i) {
+			return false;
+		}
 	}
 
-	return true;
+	return atlas->pack(renderer);
 }
 
 // Free texture memory and quit SDL and imgs
-void closeSDL(SDL_Window** window, SDL_Renderer** renderer, LTexture* textures, int numTextures) {
-	for (int i = 0; i < numTextures; i++) {
-		textures[i].free();
-	}
+void closeSDL(SDL_Window** window, SDL_Renderer** renderer, LAtlas* atlas) {
+	atlas->free();
 
 	SDL_DestroyRenderer(*renderer);
 	*renderer = NULL;
@@ -101,19 +90,19 @@ int main(int argc, char** argv) {
 	SDL_Window* window = NULL;
 	SDL_Renderer* renderer = NULL;
 
-	LTexture textures[TOTAL];
+	LAtlas atlas;
 
 	if (!init(&window, &renderer)) {
 		return -1;
 	}
-	if (!loadMedia(textures, renderer)) {
+	if (!loadMedia(&atlas, renderer)) {
 		return -1;
 	}
 
 	SDL_Event e;
 	bool quit = false;
 
-	LTexture* currTexture = NULL; // Keep track of current texture
+	LSprite* currSprite = NULL; // Keep track of current sprite
 
 	while (!quit) {
 		// Note: still need an event loop, SDL_PollEvent updates key states
@@ -125,27 +114,27 @@ int main(int argc, char** argv) {
 
 		const Uint8* currentKeyStates = SDL_GetKeyboardState(NULL);
 		if (currentKeyStates[SDL_SCANCODE_UP]) {
-			currTexture = &textures[UP];
+			currSprite = atlas.getSprite(UP);
 		} else if (currentKeyStates[SDL_SCANCODE_DOWN]) {
-			currTexture = &textures[DOWN];
+			currSprite = atlas.getSprite(DOWN);
 		} else if (currentKeyStates[SDL_SCANCODE_LEFT]) {
-			currTexture = &textures[LEFT];
+			currSprite = atlas.getSprite(LEFT);
 		} else if (currentKeyStates[SDL_SCANCODE_RIGHT]) {
-			currTexture = &textures[RIGHT];
+			currSprite = atlas.getSprite(RIGHT);
 		} else {
-			currTexture = &textures[PRESS];
+			currSprite = atlas.getSprite(PRESS);
 		}
 			
 
 		SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
 		SDL_RenderClear(renderer);
 
-		currTexture->render(renderer, 0, 0);
+		currSprite->render(renderer, 0, 0);
 
 		SDL_RenderPresent(renderer);
 	}
 
-	closeSDL(&window, &renderer, textures, TOTAL);
+	closeSDL(&window, &renderer, &atlas);
 	return 0;
 }
 
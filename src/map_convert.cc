@@ -0,0 +1,32 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "TileMap.hh"
+
+// Convert a text tile map into the binary format read by TileMap::loadFromBinary
+// Usage: map_convert <text map> <columns> <rows> <binary map> [chunk size]
+int main(int argc, char** argv) {
+	if (argc != 5 && argc != 6) {
+		std::cout << "Usage: " << argv[0] << " <text map> <columns> <rows> <binary map> [chunk size]\n";
+		return -1;
+	}
+
+	int columns = atoi(argv[2]);
+	int rows = atoi(argv[3]);
+	int chunkSize = argc == 6 ? atoi(argv[5]) : 0;
+	if (columns <= 0 || rows <= 0) {
+		std::cout << "Columns and rows must be positive\n";
+		return -1;
+	}
+
+	TileMap tileMap;
+	if (!tileMap.loadFromFile(argv[1], columns, rows)) {
+		return -1;
+	}
+	if (!tileMap.saveBinary(argv[4], chunkSize)) {
+		return -1;
+	}
+	return 0;
+}
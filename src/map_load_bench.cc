@@ -0,0 +1,76 @@
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "TileMap.hh"
+#include "LPerfTimer.hh"
+
+#define MAP_SIZE (4096)
+#define TOTAL_TILE_SPRITES (12)
+
+// Times loading a 4096x4096 tile map from text against mapping the same map
+// converted to the binary format, row by row and in chunks
+// Every file was just written, so all of them are read from the page cache.
+// Usage: map_load_bench
+
+bool makeMap(const char*);
+double timeLoad(TileMap&, const char*, bool);
+
+bool makeMap(const char* path) {
+	std::ofstream map(path);
+	for (int row = 0; row < MAP_SIZE; row++) {
+		for (int col = 0; col < MAP_SIZE; col++) {
+			map << rand() % TOTAL_TILE_SPRITES << ' ';
+		}
+		map << '\n';
+	}
+	if (map.fail()) {
+		std::cout << "Unable to write " << path << '\n';
+		return false;
+	}
+	return true;
+}
+
+// Milliseconds to load, or -1 on failure
+double timeLoad(TileMap& tileMap, const char* path, bool binary) {
+	LPerfTimer timer;
+	timer.start();
+	bool loaded = binary ? tileMap.loadFromBinary(path) : tileMap.loadFromFile(path, MAP_SIZE, MAP_SIZE);
+	return loaded ? timer.getMilliseconds() : -1;
+}
+
+int main(int argc, char** argv) {
+	const char* textPath = "map_load_bench.map";
+	const char* rowPath = "map_load_bench.lmap";
+	const char* chunkPath = "map_load_bench_chunked.lmap";
+
+	srand(1);
+	if (!makeMap(textPath)) {
+		return -1;
+	}
+
+	TileMap tileMap;
+	double textTime = timeLoad(tileMap, textPath, false);
+	bool saved = textTime >= 0 && tileMap.saveBinary(rowPath) && tileMap.saveBinary(chunkPath, 64);
+	tileMap.free();
+
+	double rowTime = saved ? timeLoad(tileMap, rowPath, true) : -1;
+	double chunkTime = saved ? timeLoad(tileMap, chunkPath, true) : -1;
+	tileMap.free();
+
+	std::remove(textPath);
+	std::remove(rowPath);
+	std::remove(chunkPath);
+	if (rowTime < 0 || chunkTime < 0) {
+		return -1;
+	}
+
+	std::cout << std::fixed << std::setprecision(1) << MAP_SIZE << "x" << MAP_SIZE << " tiles\n" <<
+		"Text:           " << textTime << " ms\n" <<
+		"Binary rows:    " << rowTime << " ms\n" <<
+		"Binary chunked: " << chunkTime << " ms\n";
+	return 0;
+}
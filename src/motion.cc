@@ -60,7 +60,10 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
 
 bool loadMedia(LTexture* texture, SDL_Renderer* renderer) {
 	*texture = LTexture();
-	if (!texture->loadFromFile("images/dot.bmp", renderer)) {
+	// Dot has a white background
+	LTextureOptions dotOptions;
+	dotOptions.key = {0xff, 0xff, 0xff, 0xff};
+	if (!texture->loadFromFile("images/dot.bmp", renderer, dotOptions)) {
 		return false;
 	}
 
@@ -0,0 +1,118 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "Collision.hh"
+#include "Dot.hh"
+#include "MultiRectCollider.hh"
+#include "LPerfTimer.hh"
+
+#define TOTAL_DOTS (1000)
+#define AREA_SIZE (300)
+
+// Checks every pair of 1000 dots' per-pixel colliders, scattered so some of
+// them overlap, with multiRectsCollide and with the check per-pix_collision
+// used to do on rect vectors passed by value, counting heap allocations
+// Usage: multi_rect_bench
+
+bool checkCollision(std::vector<SDL_Rect>, std::vector<SDL_Rect>);
+
+// Every allocation in the program goes through here to be counted
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+	allocations++;
+	void* memory = malloc(size);
+	if (memory == NULL) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* memory) noexcept {
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	free(memory);
+}
+
+// The check as it was before MultiRectCollider
+bool checkCollision(std::vector<SDL_Rect> a_rects, std::vector<SDL_Rect> b_rects) {
+	for (auto & a: a_rects) {
+		int rightA = a.x + a.w;
+		int bottomA = a.y + a.h;
+		for (auto & b: b_rects) {
+			int rightB = b.x + b.w;
+			int bottomB = b.y + b.h;
+
+			if (!(bottomA <= b.y || a.y >= bottomB || rightA <= b.x || rightB <= a.x)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+int main(int argc, char** argv) {
+	srand(1);
+	std::vector<Dot> dots;
+	dots.reserve(TOTAL_DOTS);
+	for (int i = 0; i < TOTAL_DOTS; i++) {
+		dots.emplace_back(rand() % AREA_SIZE, rand() % AREA_SIZE);
+	}
+
+	size_t queries = 0;
+	size_t oldHits = 0;
+	size_t newHits = 0;
+	int mismatches = 0;
+
+	LPerfTimer oldTimer;
+	size_t oldAllocations = allocations;
+	oldTimer.start();
+	for (int i = 0; i < TOTAL_DOTS; i++) {
+		for (int j = i + 1; j < TOTAL_DOTS; j++) {
+			oldHits += checkCollision(dots[i].getColliders().getRects(),
+																dots[j].getColliders().getRects());
+		}
+	}
+	double oldTime = oldTimer.getNanoseconds();
+	oldAllocations = allocations - oldAllocations;
+
+	LPerfTimer newTimer;
+	size_t newAllocations = allocations;
+	newTimer.start();
+	for (int i = 0; i < TOTAL_DOTS; i++) {
+		for (int j = i + 1; j < TOTAL_DOTS; j++) {
+			newHits += multiRectsCollide(dots[i].getColliders(), dots[j].getColliders());
+			queries++;
+		}
+	}
+	double newTime = newTimer.getNanoseconds();
+	newAllocations = allocations - newAllocations;
+
+	// Same answers pair by pair, outside the timed loops
+	for (int i = 0; i < TOTAL_DOTS; i++) {
+		for (int j = i + 1; j < TOTAL_DOTS; j++) {
+			if (checkCollision(dots[i].getColliders().getRects(), dots[j].getColliders().getRects()) !=
+					multiRectsCollide(dots[i].getColliders(), dots[j].getColliders())) {
+				mismatches++;
+			}
+		}
+	}
+
+	std::cout << std::fixed << std::setprecision(2) << queries << " pairs, " << newHits <<
+		" colliding\n" <<
+		"Vectors by value: " << oldTime / queries << " ns and " << (double) oldAllocations / queries <<
+		" allocations per check\n" <<
+		"MultiRectCollider: " << newTime / queries << " ns and " << (double) newAllocations / queries <<
+		" allocations per check\n";
+	if (mismatches != 0 || oldHits != newHits) {
+		std::cout << mismatches << " pairs disagreed\n";
+		return -1;
+	}
+	return 0;
+}
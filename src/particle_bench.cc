@@ -0,0 +1,144 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "LTexture.hh"
+#include "Particle.hh"
+#include "LPerfTimer.hh"
+
+#define SCREEN_WIDTH (640)
+#define SCREEN_HEIGHT (480)
+#define PARTICLE_SIZE (10)
+#define FRAMES (30)
+
+// Updates and renders growing numbers of particles with the software
+// renderer, as heap allocated Particle objects drawn one call at a time and
+// as a pooled ParticleSystem
+// Usage: particle_bench
+
+bool init(SDL_Surface**, SDL_Renderer**);
+bool makeTexture(LTexture*, Uint8, Uint8, Uint8, SDL_Renderer*);
+void closeSDL(SDL_Surface**, SDL_Renderer**);
+
+// Render into a surface so no window or display is needed
+bool init(SDL_Surface** screen, SDL_Renderer** renderer) {
+	if (SDL_Init(0) < 0) {
+		std::cout << "Init Error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+
+	*screen = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32,
+																					 SDL_PIXELFORMAT_ARGB8888);
+	if (*screen == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	*renderer = SDL_CreateSoftwareRenderer(*screen);
+	if (*renderer == NULL) {
+		std::cout << "Renderer creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	return true;
+}
+
+// Solid square, somewhat transparent like the tutorial's particles
+bool makeTexture(LTexture* texture, Uint8 r, Uint8 g, Uint8 b, SDL_Renderer* renderer) {
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, PARTICLE_SIZE, PARTICLE_SIZE, 32,
+																												SDL_PIXELFORMAT_ARGB8888);
+	if (surface == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	SDL_FillRect(surface, NULL, SDL_MapRGB(surface->format, r, g, b));
+
+	bool success = texture->loadFromSurface(surface, renderer);
+	SDL_FreeSurface(surface);
+	if (success) {
+		texture->setBlendMode(SDL_BLENDMODE_BLEND);
+		texture->setAlpha(192);
+	}
+	return success;
+}
+
+void closeSDL(SDL_Surface** screen, SDL_Renderer** renderer) {
+	SDL_DestroyRenderer(*renderer);
+	*renderer = NULL;
+	SDL_FreeSurface(*screen);
+	*screen = NULL;
+
+	SDL_Quit();
+}
+
+int main(int argc, char** argv) {
+	SDL_Surface* screen = NULL;
+	SDL_Renderer* renderer = NULL;
+	LTexture textures[TOTAL_PARTICLE_TEXTURES];
+	LTexture shimmerTexture;
+	const int counts[] = {TOTAL_PARTICLES, 1000, 100000};
+
+	srand(1);
+	if (!init(&screen, &renderer) ||
+			!makeTexture(&textures[0], 0xff, 0, 0, renderer) ||
+			!makeTexture(&textures[1], 0, 0, 0xff, renderer) ||
+			!makeTexture(&textures[2], 0, 0xff, 0, renderer) ||
+			!makeTexture(&shimmerTexture, 0xff, 0xff, 0xff, renderer)) {
+		return -1;
+	}
+
+	std::cout << std::fixed << std::setprecision(3) << "ms per frame, " << FRAMES << " frames\n";
+	for (int count: counts) {
+		std::vector<Particle*> particles(count);
+		for (auto & particle: particles) {
+			particle = new Particle(0, 0, textures);
+		}
+		ParticleSystem system(count);
+
+		LPerfTimer objectTimer;
+		LPerfTimer systemTimer;
+		for (int frame = 0; frame < FRAMES; frame++) {
+			int x = frame * 10 % (SCREEN_WIDTH - 20);
+			int y = frame * 7 % (SCREEN_HEIGHT - 20);
+
+			// What ParticleDot::renderParticles used to do
+			SDL_RenderClear(renderer);
+			objectTimer.start();
+			for (auto & particle: particles) {
+				if (particle->isDead()) {
+					delete particle;
+					particle = new Particle(x, y, textures);
+				}
+			}
+			for (auto & particle: particles) {
+				particle->render(&shimmerTexture, renderer);
+			}
+			SDL_RenderPresent(renderer);
+			objectTimer.lap();
+
+			SDL_RenderClear(renderer);
+			systemTimer.start();
+			system.update(x, y);
+			system.render(renderer, textures, &shimmerTexture);
+			SDL_RenderPresent(renderer);
+			systemTimer.lap();
+		}
+
+		for (auto & particle: particles) {
+			delete particle;
+		}
+
+		std::cout << std::setw(6) << count << " particles: Particle " <<
+			objectTimer.getAverageLap() / 1000000 << ", ParticleSystem " <<
+			systemTimer.getAverageLap() / 1000000 << '\n';
+	}
+
+	for (auto & texture: textures) {
+		texture.free();
+	}
+	shimmerTexture.free();
+	closeSDL(&screen, &renderer);
+	return 0;
+}
@@ -9,6 +9,7 @@
 
 #include "LTexture.hh"
 #include "Particle.hh"
+#include "LAssetLoader.hh"
 
 #define SCREEN_WIDTH (640)
 #define SCREEN_HEIGHT (480)
@@ -60,23 +61,20 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
 
 bool loadMedia(LTexture* textures, LTexture* dotTexturePtr,
 							 LTexture* shimmerTexturePtr, SDL_Renderer* renderer) {
-	if (!dotTexturePtr->loadFromFile("images/dot.bmp", renderer)) {
-		return false;
-	}
-
 	for (int i = 0; i < 3; i++) {
 		textures[i] = LTexture();
 	}
-	if (!textures[0].loadFromFile("images/red.bmp", renderer)) {
-		return false;
-	}
-	if (!textures[1].loadFromFile("images/blue.bmp", renderer)) {
-		return false;
-	}
-	if (!textures[2].loadFromFile("images/green.bmp", renderer)) {
-		return false;
-	}
-	if (!shimmerTexturePtr->loadFromFile("images/shimmer.bmp", renderer)) {
+
+	// Images are decoded in parallel, then uploaded here as each one finishes
+	LAssetLoader loader;
+	LTextureOptions dotOptions;
+	dotOptions.key = {0xff, 0xff, 0xff, 0xff};
+	loader.load("images/dot.bmp", dotTexturePtr, renderer, dotOptions);
+	loader.load("images/red.bmp", &textures[0], renderer);
+	loader.load("images/blue.bmp", &textures[1], renderer);
+	loader.load("images/green.bmp", &textures[2], renderer);
+	loader.load("images/shimmer.bmp", shimmerTexturePtr, renderer);
+	if (!loader.finish(renderer)) {
 		return false;
 	}
 
@@ -125,7 +123,7 @@ int main(int argc, char** argv) {
 
 	SDL_Event e;
 	bool quit = false;
-	ParticleDot dot = ParticleDot(textures);
+	ParticleDot dot;
 	while (!quit) {
 		int startTime = SDL_GetTicks(); // Simple way to cap frame rate
 		while (SDL_PollEvent(&e) != 0) {
@@ -9,7 +9,9 @@
 #include <iostream>
 
 #include "LTexture.hh"
+#include "Collision.hh"
 #include "Dot.hh"
+#include "MultiRectCollider.hh"
 
 #define SCREEN_WIDTH (640)
 #define SCREEN_HEIGHT (480)
@@ -19,7 +21,6 @@
 bool init(SDL_Window**, SDL_Renderer**);
 bool loadMedia(LTexture*, SDL_Renderer*);
 void closeSDL(SDL_Window**, SDL_Renderer**, LTexture*, int);
-bool checkCollision(std::vector<SDL_Rect>, std::vector<SDL_Rect>);
 
 // Initialize SDL, Window, Renderer, Image, and TTF
 bool init(SDL_Window** window, SDL_Renderer** renderer) {
@@ -63,7 +64,10 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
 
 bool loadMedia(LTexture* texture, SDL_Renderer* renderer) {
 	*texture = LTexture();
-	if (!texture->loadFromFile("images/dot.bmp", renderer)) {
+	// Dot has a white background
+	LTextureOptions dotOptions;
+	dotOptions.key = {0xff, 0xff, 0xff, 0xff};
+	if (!texture->loadFromFile("images/dot.bmp", renderer, dotOptions)) {
 		return false;
 	}
 
@@ -86,26 +90,6 @@ void closeSDL(SDL_Window** window, SDL_Renderer** renderer,
 	TTF_Quit();
 }
 
-// Checks that both axises of the two rectangles do not collide with each
-// other. Returns true when they collide
-bool checkCollision(std::vector<SDL_Rect> a_rects, std::vector<SDL_Rect> b_rects) {
-	for (auto & a: a_rects) {
-		int rightA = a.x + a.w;
-		int bottomA = a.y + a.h;
-		for (auto & b: b_rects) {
-			int rightB = b.x + b.w;
-			int bottomB = b.y + b.h;
-
-			// Check if any side is inside of the collision 
-			// Opposite of previous lesson incase we can finish early
-			if (!(bottomA <= b.y || a.y >= bottomB || rightA <= b.x || rightB <= a.x)) {
-				return true;
-			}
-		}
-	}
-	return false; // No collision
-}
-
 int main(int argc, char** argv) {
 	SDL_Window* window = NULL;
 	SDL_Renderer* renderer = NULL;
@@ -133,7 +117,7 @@ int main(int argc, char** argv) {
 			}
 			dot.handleEvent(e);
 		}
-		dot.move(collideDot.getColliders(), checkCollision);
+		dot.move(collideDot.getColliders(), multiRectsCollide);
 
 		SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
 		SDL_RenderClear(renderer);
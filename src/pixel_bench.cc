@@ -0,0 +1,159 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "PixelOps.hh"
+#include "LPerfTimer.hh"
+
+#define IMAGE_WIDTH (3840)
+#define IMAGE_HEIGHT (2160)
+#define REPEATS (5)
+
+// Runs each pixel operation over a 4K ARGB8888 image, as the per-pixel
+// SDL_GetRGBA and SDL_MapRGBA loop the tutorials use and through PixelOps,
+// and checks both give the same pixels
+// Usage: pixel_bench
+
+typedef void (*PixelLoop)(Uint32*, size_t, const SDL_PixelFormat*);
+
+struct PixelBenchOp {
+	const char* name;
+	PixelLoop perPixel;
+	PixelLoop pixelOps;
+};
+
+Uint8 scale(Uint8, Uint8); // value * factor / 255, rounded
+
+// Per-pixel versions, rounding the same way as PixelOps
+void keyLoop(Uint32*, size_t, const SDL_PixelFormat*);
+void tintLoop(Uint32*, size_t, const SDL_PixelFormat*);
+void alphaLoop(Uint32*, size_t, const SDL_PixelFormat*);
+void premultiplyLoop(Uint32*, size_t, const SDL_PixelFormat*);
+void grayscaleLoop(Uint32*, size_t, const SDL_PixelFormat*);
+
+void keyOps(Uint32*, size_t, const SDL_PixelFormat*);
+void tintOps(Uint32*, size_t, const SDL_PixelFormat*);
+void alphaOps(Uint32*, size_t, const SDL_PixelFormat*);
+
+double timeLoop(PixelLoop, std::vector<Uint32>&, std::vector<Uint32>&, const SDL_PixelFormat*);
+
+Uint8 scale(Uint8 value, Uint8 factor) {
+	return (value * factor + 127) / 255;
+}
+
+void keyLoop(Uint32* pixels, size_t count, const SDL_PixelFormat* format) {
+	Uint32 colorKey = SDL_MapRGBA(format, 0xff, 0, 0xff, 0xff);
+	Uint32 transparent = SDL_MapRGBA(format, 0xff, 0xff, 0xff, 0);
+	for (size_t i = 0; i < count; i++) {
+		if (pixels[i] == colorKey) {
+			pixels[i] = transparent;
+		}
+	}
+}
+
+void tintLoop(Uint32* pixels, size_t count, const SDL_PixelFormat* format) {
+	Uint8 r, g, b, a;
+	for (size_t i = 0; i < count; i++) {
+		SDL_GetRGBA(pixels[i], format, &r, &g, &b, &a);
+		pixels[i] = SDL_MapRGBA(format, scale(r, 0xff), scale(g, 0x80), scale(b, 0x40), a);
+	}
+}
+
+void alphaLoop(Uint32* pixels, size_t count, const SDL_PixelFormat* format) {
+	Uint8 r, g, b, a;
+	for (size_t i = 0; i < count; i++) {
+		SDL_GetRGBA(pixels[i], format, &r, &g, &b, &a);
+		pixels[i] = SDL_MapRGBA(format, r, g, b, scale(a, 0xc0));
+	}
+}
+
+void premultiplyLoop(Uint32* pixels, size_t count, const SDL_PixelFormat* format) {
+	Uint8 r, g, b, a;
+	for (size_t i = 0; i < count; i++) {
+		SDL_GetRGBA(pixels[i], format, &r, &g, &b, &a);
+		pixels[i] = SDL_MapRGBA(format, scale(r, a), scale(g, a), scale(b, a), a);
+	}
+}
+
+void grayscaleLoop(Uint32* pixels, size_t count, const SDL_PixelFormat* format) {
+	Uint8 r, g, b, a;
+	for (size_t i = 0; i < count; i++) {
+		SDL_GetRGBA(pixels[i], format, &r, &g, &b, &a);
+		Uint8 gray = (r * 77 + g * 150 + b * 29) >> 8;
+		pixels[i] = SDL_MapRGBA(format, gray, gray, gray, a);
+	}
+}
+
+void keyOps(Uint32* pixels, size_t count, const SDL_PixelFormat* format) {
+	pixelReplaceKey(pixels, count, SDL_MapRGBA(format, 0xff, 0, 0xff, 0xff),
+									SDL_MapRGBA(format, 0xff, 0xff, 0xff, 0));
+}
+
+void tintOps(Uint32* pixels, size_t count, const SDL_PixelFormat* format) {
+	pixelTint(pixels, count, format, 0xff, 0x80, 0x40);
+}
+
+void alphaOps(Uint32* pixels, size_t count, const SDL_PixelFormat* format) {
+	pixelMultiplyAlpha(pixels, count, format, 0xc0);
+}
+
+// Average milliseconds to run loop over a fresh copy of image, leaving the
+// result in work
+double timeLoop(PixelLoop loop, std::vector<Uint32>& image, std::vector<Uint32>& work,
+								const SDL_PixelFormat* format) {
+	LPerfTimer timer;
+	for (int i = 0; i < REPEATS; i++) {
+		work = image;
+		timer.start();
+		loop(work.data(), work.size(), format);
+		timer.lap();
+	}
+	return timer.getAverageLap() / 1000000;
+}
+
+int main(int argc, char** argv) {
+	SDL_PixelFormat* format = SDL_AllocFormat(SDL_PIXELFORMAT_ARGB8888);
+	if (format == NULL) {
+		std::cout << "Unable to allocate pixel format: " << SDL_GetError() << '\n';
+		return -1;
+	}
+
+	// Random pixels, a third of them the color key
+	srand(1);
+	Uint32 colorKey = SDL_MapRGBA(format, 0xff, 0, 0xff, 0xff);
+	std::vector<Uint32> image((size_t) IMAGE_WIDTH * IMAGE_HEIGHT);
+	for (auto & pixel: image) {
+		pixel = rand() % 3 == 0 ? colorKey : SDL_MapRGBA(format, rand() % 0x100, rand() % 0x100,
+																										rand() % 0x100, rand() % 0x100);
+	}
+
+	const PixelBenchOp ops[] = {
+		{"Color key replace", keyLoop, keyOps},
+		{"Tint", tintLoop, tintOps},
+		{"Alpha multiply", alphaLoop, alphaOps},
+		{"Premultiply", premultiplyLoop, pixelPremultiply},
+		{"Grayscale", grayscaleLoop, pixelGrayscale}
+	};
+
+	std::vector<Uint32> loopResult;
+	std::vector<Uint32> opsResult;
+	bool matched = true;
+	std::cout << std::fixed << std::setprecision(2) << IMAGE_WIDTH << "x" << IMAGE_HEIGHT <<
+		" pixels, ms per pass, PixelOps using " << getPixelOpsTarget() << '\n';
+	for (auto & op: ops) {
+		double loopTime = timeLoop(op.perPixel, image, loopResult, format);
+		double opsTime = timeLoop(op.pixelOps, image, opsResult, format);
+		bool same = memcmp(loopResult.data(), opsResult.data(), image.size() * 4) == 0;
+		matched = matched && same;
+
+		std::cout << std::left << std::setw(18) << op.name << std::right << " per pixel " <<
+			std::setw(8) << loopTime << ", PixelOps " << std::setw(7) << opsTime <<
+			(same ? "" : "  MISMATCH") << '\n';
+	}
+
+	SDL_FreeFormat(format);
+	return matched ? 0 : -1;
+}
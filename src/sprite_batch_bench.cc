@@ -0,0 +1,156 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "LTexture.hh"
+#include "LSpriteBatch.hh"
+#include "LPerfTimer.hh"
+
+#define SCREEN_WIDTH (640)
+#define SCREEN_HEIGHT (480)
+#define SHEET_SIZE (256)
+#define SPRITE_SIZE (32)
+#define TOTAL_SPRITES (10000)
+#define FRAMES (60)
+
+// Draws 10k quads from one sprite sheet per frame with the software
+// renderer, one LTexture::render call each and through LSpriteBatch, first
+// plain and then with a color, alpha and rotation per quad
+// Usage: sprite_batch_bench
+
+struct Quad {
+	int x, y;
+	SDL_Rect clip;
+	SDL_Color color;
+	double angle;
+};
+
+bool init(SDL_Surface**, SDL_Renderer**);
+bool makeSheet(LTexture*, SDL_Renderer*);
+void closeSDL(SDL_Surface**, SDL_Renderer**);
+
+// Render into a surface so no window or display is needed
+bool init(SDL_Surface** screen, SDL_Renderer** renderer) {
+	if (SDL_Init(0) < 0) {
+		std::cout << "Init Error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+
+	*screen = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32,
+																					 SDL_PIXELFORMAT_ARGB8888);
+	if (*screen == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	*renderer = SDL_CreateSoftwareRenderer(*screen);
+	if (*renderer == NULL) {
+		std::cout << "Renderer creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	return true;
+}
+
+// Sheet of differently colored sprites
+bool makeSheet(LTexture* sheet, SDL_Renderer* renderer) {
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, SHEET_SIZE, SHEET_SIZE, 32,
+																												SDL_PIXELFORMAT_ARGB8888);
+	if (surface == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	for (int y = 0; y < SHEET_SIZE; y += SPRITE_SIZE) {
+		for (int x = 0; x < SHEET_SIZE; x += SPRITE_SIZE) {
+			SDL_Rect sprite = {x, y, SPRITE_SIZE, SPRITE_SIZE};
+			SDL_FillRect(surface, &sprite, SDL_MapRGB(surface->format, x, y, 0x80));
+		}
+	}
+
+	bool success = sheet->loadFromSurface(surface, renderer);
+	SDL_FreeSurface(surface);
+	if (success) {
+		sheet->setBlendMode(SDL_BLENDMODE_BLEND);
+	}
+	return success;
+}
+
+void closeSDL(SDL_Surface** screen, SDL_Renderer** renderer) {
+	SDL_DestroyRenderer(*renderer);
+	*renderer = NULL;
+	SDL_FreeSurface(*screen);
+	*screen = NULL;
+
+	SDL_Quit();
+}
+
+int main(int argc, char** argv) {
+	SDL_Surface* screen = NULL;
+	SDL_Renderer* renderer = NULL;
+	LTexture sheet;
+
+	srand(1);
+	if (!init(&screen, &renderer) || !makeSheet(&sheet, renderer)) {
+		return -1;
+	}
+
+	std::vector<Quad> quads(TOTAL_SPRITES);
+	int perRow = SHEET_SIZE / SPRITE_SIZE;
+	for (auto & quad: quads) {
+		int sprite = rand() % (perRow * perRow);
+		quad.x = rand() % SCREEN_WIDTH;
+		quad.y = rand() % SCREEN_HEIGHT;
+		quad.clip = {sprite % perRow * SPRITE_SIZE, sprite / perRow * SPRITE_SIZE, SPRITE_SIZE, SPRITE_SIZE};
+		quad.color = {(Uint8) (rand() % 0x100), (Uint8) (rand() % 0x100), (Uint8) (rand() % 0x100),
+									(Uint8) (0x80 + rand() % 0x80)};
+		quad.angle = rand() % 360;
+	}
+
+	LSpriteBatch batch;
+	std::cout << std::fixed << std::setprecision(3) << TOTAL_SPRITES << " quads, ms per frame over " <<
+		FRAMES << " frames\n";
+	for (int styled = 0; styled < 2; styled++) {
+		LPerfTimer copyTimer;
+		LPerfTimer batchTimer;
+		for (int frame = 0; frame < FRAMES; frame++) {
+			SDL_RenderClear(renderer);
+			copyTimer.start();
+			for (auto & quad: quads) {
+				if (styled) {
+					sheet.setColor(quad.color.r, quad.color.g, quad.color.b);
+					sheet.setAlpha(quad.color.a);
+				}
+				sheet.render(renderer, quad.x, quad.y, &quad.clip, styled ? quad.angle : 0);
+			}
+			SDL_RenderPresent(renderer);
+			copyTimer.lap();
+
+			// The batch folds in the texture's modulation, so reset it first
+			sheet.setColor(0xff, 0xff, 0xff);
+			sheet.setAlpha(0xff);
+
+			SDL_RenderClear(renderer);
+			batchTimer.start();
+			for (auto & quad: quads) {
+				if (styled) {
+					batch.draw(renderer, &sheet, quad.x, quad.y, &quad.clip, quad.color, quad.angle);
+				} else {
+					batch.draw(renderer, &sheet, quad.x, quad.y, &quad.clip);
+				}
+			}
+			batch.flush(renderer);
+			SDL_RenderPresent(renderer);
+			batchTimer.lap();
+		}
+
+		std::cout << (styled ? "Color, alpha, rotation: " : "Plain: ") << "render " <<
+			copyTimer.getAverageLap() / 1000000 << ", batch " << batchTimer.getAverageLap() / 1000000 << '\n';
+	}
+
+	sheet.free();
+	closeSDL(&screen, &renderer);
+	return 0;
+}
@@ -0,0 +1,120 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "LTexture.hh"
+#include "LGlyphCache.hh"
+#include "LPerfTimer.hh"
+
+#define SCREEN_WIDTH (640)
+#define SCREEN_HEIGHT (480)
+#define UPDATES (10000)
+
+// Updates and draws an FPS counter 10k times with the software renderer,
+// rendering a new text texture each time and through a glyph cache
+// Usage: text_bench [font]
+
+bool init(SDL_Surface**, SDL_Renderer**);
+void closeSDL(SDL_Surface**, SDL_Renderer**, TTF_Font**);
+
+// Render into a surface so no window or display is needed
+bool init(SDL_Surface** screen, SDL_Renderer** renderer) {
+	if (SDL_Init(0) < 0) {
+		std::cout << "Init Error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+
+	*screen = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32,
+																					 SDL_PIXELFORMAT_ARGB8888);
+	if (*screen == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	*renderer = SDL_CreateSoftwareRenderer(*screen);
+	if (*renderer == NULL) {
+		std::cout << "Renderer creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	if (TTF_Init() == -1) {
+		std::cout << "TTF Init error: " << TTF_GetError() << '\n';
+		return false;
+	}
+	return true;
+}
+
+void closeSDL(SDL_Surface** screen, SDL_Renderer** renderer, TTF_Font** font) {
+	TTF_CloseFont(*font);
+	*font = NULL;
+
+	SDL_DestroyRenderer(*renderer);
+	*renderer = NULL;
+	SDL_FreeSurface(*screen);
+	*screen = NULL;
+
+	TTF_Quit();
+	SDL_Quit();
+}
+
+int main(int argc, char** argv) {
+	SDL_Surface* screen = NULL;
+	SDL_Renderer* renderer = NULL;
+	TTF_Font* font = NULL;
+	std::string fontPath = argc > 1 ? argv[1] : "fonts/lazy.ttf";
+
+	if (!init(&screen, &renderer)) {
+		return -1;
+	}
+	font = TTF_OpenFont(fontPath.c_str(), 28);
+	if (font == NULL) {
+		std::cout << "Font load error (" << fontPath << "): " << TTF_GetError() << '\n';
+		return -1;
+	}
+
+	SDL_Color textColor = {0, 0, 0, 0xff};
+	std::stringstream timeText;
+
+	// What frame_rate used to do every frame
+	LTexture textTexture;
+	LPerfTimer textureTimer;
+	textureTimer.start();
+	for (int i = 0; i < UPDATES; i++) {
+		timeText.str("");
+		timeText << "Average Frames Per Second " << 60.0 - i % 100 / 10.0;
+		if (!textTexture.loadFromRenderedText(timeText.str(), textColor, renderer, font)) {
+			return -1;
+		}
+		textTexture.render(renderer, 0, 0);
+		SDL_RenderPresent(renderer);
+	}
+	double textureTime = textureTimer.getMilliseconds();
+	textTexture.free();
+
+	LGlyphCache glyphs;
+	LPerfTimer glyphTimer;
+	glyphTimer.start();
+	if (!glyphs.build(font, renderer)) {
+		return -1;
+	}
+	double buildTime = glyphTimer.getMilliseconds();
+	for (int i = 0; i < UPDATES; i++) {
+		timeText.str("");
+		timeText << "Average Frames Per Second " << 60.0 - i % 100 / 10.0;
+		glyphs.renderText(renderer, 0, 0, timeText.str(), textColor);
+		SDL_RenderPresent(renderer);
+	}
+	double glyphTime = glyphTimer.getMilliseconds();
+	glyphs.free();
+
+	std::cout << std::fixed << std::setprecision(1) << UPDATES << " counter updates\n" <<
+		"Rendered text texture: " << textureTime << " ms\n" <<
+		"Glyph cache:           " << glyphTime << " ms (" << buildTime << " ms building it)\n";
+
+	closeSDL(&screen, &renderer, &font);
+	return 0;
+}
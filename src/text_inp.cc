@@ -7,13 +7,14 @@
 #include <iostream>
 
 #include "LTexture.hh"
+#include "LGlyphCache.hh"
 
 #define SCREEN_WIDTH (640)
 #define SCREEN_HEIGHT (480)
 
 bool init(SDL_Window**, SDL_Renderer**);
-bool loadMedia(LTexture*, SDL_Renderer*, TTF_Font**);
-void closeSDL(SDL_Window**, SDL_Renderer**, TTF_Font**, LTexture*, int);
+bool loadMedia(LTexture*, LGlyphCache*, SDL_Renderer*, TTF_Font**);
+void closeSDL(SDL_Window**, SDL_Renderer**, TTF_Font**, LTexture*, int, LGlyphCache*);
 
 // Initialize SDL, Window, Renderer, Image, and TTF
 bool init(SDL_Window** window, SDL_Renderer** renderer) {
@@ -55,7 +56,8 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
 	return true;
 }
 
-bool loadMedia(LTexture* texture, SDL_Renderer* renderer, TTF_Font** font_ptr) {
+bool loadMedia(LTexture* texture, LGlyphCache* glyphs, SDL_Renderer* renderer,
+							 TTF_Font** font_ptr) {
 	// First arg is font file, second is point size to render at
 	*font_ptr = TTF_OpenFont("fonts/lazy.ttf", 28);
 	if (*font_ptr == NULL) {
@@ -71,14 +73,20 @@ bool loadMedia(LTexture* texture, SDL_Renderer* renderer, TTF_Font** font_ptr) {
 																		 *font_ptr))	{
 		return false;
 	}
+
+	// Typed text is drawn from cached glyphs instead of a new texture per edit
+	if (!glyphs->build(*font_ptr, renderer)) {
+		return false;
+	}
 	return true;
 }
 
 void closeSDL(SDL_Window** window, SDL_Renderer** renderer, TTF_Font** font_ptr,
-							LTexture* textures, int numTextures) {
+							LTexture* textures, int numTextures, LGlyphCache* glyphs) {
 	for (int i = 0; i < numTextures; i++) {
 		textures[i].free();
 	}
+	glyphs->free();
 
 	TTF_CloseFont(*font_ptr);
 	*font_ptr = NULL;
@@ -98,12 +106,13 @@ int main(int argc, char** argv) {
 	SDL_Renderer* renderer = NULL;
 	TTF_Font* font = NULL;
 
-	LTexture textures[2];
+	LTexture prompt;
+	LGlyphCache glyphs;
 
 	if (!init(&window, &renderer)) {
 		return -1;
 	}
-	if (!loadMedia(textures, renderer, &font)) {
+	if (!loadMedia(&prompt, &glyphs, renderer, &font)) {
 		return -1;
 	}
 
@@ -114,12 +123,10 @@ int main(int argc, char** argv) {
 	SDL_Color textColor = {0, 0, 0, 0xff};
 
 	std::string currText = "Some Text";
-	textures[1].loadFromRenderedText(currText.c_str(), textColor, renderer, font);
 
 	SDL_StartTextInput(); // Start listening for text input
 
 	while (!quit) {
-		bool renderText = false;
 		while (SDL_PollEvent(&e) != 0) {
 			if (e.type == SDL_QUIT) {
 				quit = true;
@@ -128,15 +135,12 @@ int main(int argc, char** argv) {
 				// Note use binary & to check ctrl keys
 				if (e.key.keysym.sym == SDLK_BACKSPACE && currText.length() > 0) {
 					currText.pop_back();
-					renderText = true;
 				} else if (e.key.keysym.sym == SDLK_c && SDL_GetModState() &
 									 KMOD_CTRL) { // Check ctrl-c (copy)
 					SDL_SetClipboardText(currText.c_str());
-					renderText = true;
 				} else if (e.key.keysym.sym == SDLK_v && SDL_GetModState() &
 									 KMOD_CTRL) { // Check ctrl-v (paste)
 					currText = SDL_GetClipboardText();
-					renderText = true;
 				}
 			} else if (e.type == SDL_TEXTINPUT) { 
 				// These events simplify capitalization inputs, handle that work
@@ -146,31 +150,21 @@ int main(int argc, char** argv) {
 						 (e.text.text[0] == 'c' || e.text.text[0] == 'C' ||
 						  e.text.text[0] == 'v' || e.text.text[0] == 'V'))) {
 					currText += e.text.text;
-					renderText = true;
 				}
 			}	
 		}
 
-		if (renderText) {
-			if (currText.length() > 0) {
-				textures[1].loadFromRenderedText(currText.c_str(), textColor,
-																					 renderer, font);
-			} else { // Empty text
-				textures[1].loadFromRenderedText(" ", textColor, renderer, font);
-			}
-		}
-
 		SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
 		SDL_RenderClear(renderer);
 
-		textures[0].render(renderer, (SCREEN_WIDTH - textures[0].getWidth()) / 2, 0);
-		textures[1].render(renderer, (SCREEN_WIDTH - textures[1].getWidth()) / 2,
-											 textures[0].getHeight());
+		prompt.render(renderer, (SCREEN_WIDTH - prompt.getWidth()) / 2, 0);
+		glyphs.renderText(renderer, (SCREEN_WIDTH - glyphs.getTextWidth(currText)) / 2,
+											prompt.getHeight(), currText, textColor);
 
 		SDL_RenderPresent(renderer);
 	}
 	SDL_StopTextInput();
 
-	closeSDL(&window, &renderer, &font, textures, 2);
+	closeSDL(&window, &renderer, &font, &prompt, 1, &glyphs);
 	return 0;
 }
@@ -52,22 +52,13 @@ bool loadMedia(LTexture* texture, SDL_Window* window,
 	}
 
 	// Manipulate the pixels of the texture
-
-	// Pixel data
-	Uint32* pixels = texture->getPixels32();
-	Uint32 pixelCount = texture->getPitch32() * texture->getHeight();;
-
 	Uint32 colorKey = SDL_MapRGBA(SDL_GetWindowSurface(window)->format,
 																0xff, 0, 0xff, 0xff);
 	Uint32 transparent = SDL_MapRGBA(SDL_GetWindowSurface(window)->format,
 																	 0xff, 0xff, 0xff, 0);
 
 	// Make all background pixels transparent
-	for (Uint32 i = 0; i < pixelCount; i++) {
-		if (pixels[i] == colorKey) {
-			pixels[i] = transparent;
-		}
-	}
+	texture->replacePixels(colorKey, transparent);
 
 	if (!texture->loadFromPixels(renderer)) {
 		return false;
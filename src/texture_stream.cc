@@ -1,24 +1,47 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <atomic>
+#include <cstring>
 #include <sstream>
 #include <iostream>
+#include <thread>
 
 #include "LTexture.hh"
+#include "FrameRing.hh"
 
 #define SCREEN_WIDTH (640)
 #define SCREEN_HEIGHT (480)
 
+#define STREAM_TICKS_PER_FRAME (1000 / 60)
+
+// Source of animation frames produced on a background thread
+// Frames go through a FrameRing, so the render loop takes the newest one
+// without waiting and frames it did not get to in time are dropped
 class DataStream {
 	public:
 		DataStream();
 		bool loadMedia();
 		void free();
-		void* getBuffer();
+		bool writeFrame(void*, int); // Write next frame to pixels with pitch
+
+		bool start(); // Start producing frames
+		void stop();
+
+		// Newest produced frame or NULL if there is none since the last call
+		const Uint8* acquireFrame();
+		int getFramePitch(); // Bytes per row of produced frames
+		FrameRing* getFrames(); // Frame statistics
 	
 	private:
 		SDL_Surface* mImages[4];
 		int mCurrentImage;
 		int mDelayFrames;
+
+		FrameRing mFrames;
+		std::thread mProducer;
+		std::atomic<bool> mQuit;
+
+		void produce(); // Producer thread body
 };
 
 DataStream::DataStream() {
@@ -28,6 +51,7 @@ DataStream::DataStream() {
 
 	mCurrentImage = 0;
 	mDelayFrames = 4;
+	mQuit = false;
 }
 
 bool DataStream::loadMedia() {
@@ -47,13 +71,20 @@ bool DataStream::loadMedia() {
 }
 
 void DataStream::free() {
+	stop();
+	mFrames.free();
 	for (int i = 0; i < 4; i++) {
 		SDL_FreeSurface(mImages[i]);
 		mImages[i] = NULL;
 	}
 }
 
-void* DataStream::getBuffer() {
+/**
+ * Advance the animation and write the current frame into the given pixels,
+ * usually a locked texture, so the frame needs no buffer in between
+ * Rows are copied one at a time only when the pitches differ
+ */
+bool DataStream::writeFrame(void* pixels, int pitch) {
 	--mDelayFrames;
 	if (mDelayFrames == 0) {
 		++mCurrentImage;
@@ -62,7 +93,62 @@ void* DataStream::getBuffer() {
 	if (mCurrentImage == 4) {
 		mCurrentImage = 0;
 	}
-	return mImages[mCurrentImage]->pixels;
+
+	SDL_Surface* image = mImages[mCurrentImage];
+	if (image == NULL || pixels == NULL) {
+		return false;
+	}
+	if (pitch == image->pitch) {
+		memcpy(pixels, image->pixels, (size_t) pitch * image->h);
+	} else {
+		for (int row = 0; row < image->h; row++) {
+			memcpy(static_cast<Uint8*>(pixels) + row * pitch,
+						 static_cast<Uint8*>(image->pixels) + row * image->pitch, image->w * 4);
+		}
+	}
+	return true;
+}
+
+// Frames are packed rows of the first image's size
+bool DataStream::start() {
+	if (mImages[0] == NULL || mProducer.joinable()) {
+		return false;
+	}
+	if (!mFrames.create((size_t) getFramePitch() * mImages[0]->h)) {
+		return false;
+	}
+
+	mQuit = false;
+	mProducer = std::thread(&DataStream::produce, this);
+	return true;
+}
+
+void DataStream::stop() {
+	if (mProducer.joinable()) {
+		mQuit = true;
+		mProducer.join();
+	}
+}
+
+const Uint8* DataStream::acquireFrame() {
+	return mFrames.acquire();
+}
+
+int DataStream::getFramePitch() {
+	return mImages[0] != NULL ? mImages[0]->w * 4 : 0;
+}
+
+FrameRing* DataStream::getFrames() {
+	return &mFrames;
+}
+
+// Write a frame each tick into the ring, independent of the render loop
+void DataStream::produce() {
+	while (!mQuit) {
+		writeFrame(mFrames.getWriteBuffer(), getFramePitch());
+		mFrames.publish();
+		SDL_Delay(STREAM_TICKS_PER_FRAME);
+	}
 }
 
 bool init(SDL_Window** window, SDL_Renderer** renderer) {
@@ -106,6 +192,10 @@ bool loadMedia(LTexture* texture, DataStream* dataStream, SDL_Renderer* renderer
 	if (!dataStream->loadMedia()) {
 		return false;
 	}
+	if (!dataStream->start()) {
+		std::cout << "Unable to start data stream\n";
+		return false;
+	}
 	return true;
 }
 
@@ -148,10 +238,12 @@ int main(int argc, char** argv) {
 		SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
 		SDL_RenderClear(renderer);
 
-		// Copy frame in buffer
-		texture.lockTexture();
-		texture.copyRawPixels32(dataStream.getBuffer());
-		texture.unlockTexture();
+		// Upload the newest frame if one arrived, otherwise keep the last one
+		const Uint8* frame = dataStream.acquireFrame();
+		if (frame != NULL && texture.lockTexture()) {
+			texture.copyRawPixels32(frame, dataStream.getFramePitch());
+			texture.unlockTexture();
+		}
 
 		texture.render(renderer, (SCREEN_WIDTH - texture.getWidth()) / 2,
 									 (SCREEN_HEIGHT - texture.getHeight()) / 2);
@@ -159,6 +251,11 @@ int main(int argc, char** argv) {
 		SDL_RenderPresent(renderer);
 	}
 
+	FrameRing* frames = dataStream.getFrames();
+	std::cout << "Frames produced: " << frames->getPublished() << ", dropped: "
+						<< frames->getDropped() << ", average latency: "
+						<< frames->getAverageLatency() << " ms\n";
+
 	closeSDL(&window, &renderer, &dataStream, &texture);
 	return 0;
 }
@@ -0,0 +1,106 @@
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "TileMap.hh"
+#include "Tile.hh"
+#include "LPerfTimer.hh"
+
+#define MAP_COLUMNS (1000)
+#define MAP_ROWS (1000)
+#define DOT_WIDTH (20)
+#define DOT_HEIGHT (20)
+#define GRID_QUERIES (1000000)
+#define SCAN_QUERIES (100)
+
+// Times wall checks for a dot sized box on a 1000x1000 tile map, through
+// TileMap's cell lookup and through a scan of every tile like the old
+// touchesWall
+// Usage: tile_bench
+
+bool makeMap(const char*);
+bool scanWalls(TileMap&, SDL_Rect&);
+
+// Random floor with roughly one wall tile in twenty
+bool makeMap(const char* path) {
+	std::ofstream map(path);
+	for (int row = 0; row < MAP_ROWS; row++) {
+		for (int col = 0; col < MAP_COLUMNS; col++) {
+			int type = rand() % 20 == 0 ? TILE_CENTER + rand() % 9 : rand() % 3;
+			map << type << ' ';
+		}
+		map << '\n';
+	}
+	if (map.fail()) {
+		std::cout << "Unable to write " << path << '\n';
+		return false;
+	}
+	return true;
+}
+
+// Check every tile's box, the cost of the old touchesWall
+bool scanWalls(TileMap& tileMap, SDL_Rect& box) {
+	for (int i = 0; i < tileMap.getTotalTiles(); i++) {
+		TileTypes type = tileMap.getType(i);
+		if (type >= TILE_CENTER && type <= TILE_TOPLEFT && checkCollision(box, tileMap.getBox(i))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int main(int argc, char** argv) {
+	const char* path = "tile_bench.map";
+
+	srand(1);
+	if (!makeMap(path)) {
+		return -1;
+	}
+	TileMap tileMap;
+	bool loaded = tileMap.loadFromFile(path, MAP_COLUMNS, MAP_ROWS);
+	std::remove(path);
+	if (!loaded) {
+		return -1;
+	}
+
+	std::vector<SDL_Rect> boxes(GRID_QUERIES);
+	for (auto & box: boxes) {
+		box = {rand() % (tileMap.getLevelWidth() - DOT_WIDTH),
+					 rand() % (tileMap.getLevelHeight() - DOT_HEIGHT), DOT_WIDTH, DOT_HEIGHT};
+	}
+
+	LPerfTimer timer;
+	int gridHits = 0;
+	timer.start();
+	for (auto & box: boxes) {
+		gridHits += tileMap.touchesWall(box);
+	}
+	double gridTime = (double) timer.getNanoseconds() / GRID_QUERIES;
+
+	std::vector<bool> scanned(SCAN_QUERIES);
+	timer.start();
+	for (int i = 0; i < SCAN_QUERIES; i++) {
+		scanned[i] = scanWalls(tileMap, boxes[i]);
+	}
+	double scanTime = (double) timer.getNanoseconds() / SCAN_QUERIES;
+
+	int scanHits = 0;
+	int mismatches = 0;
+	for (int i = 0; i < SCAN_QUERIES; i++) {
+		scanHits += scanned[i];
+		mismatches += scanned[i] != tileMap.touchesWall(boxes[i]);
+	}
+
+	std::cout << std::fixed << std::setprecision(1) << MAP_COLUMNS << "x" << MAP_ROWS << " tiles\n" <<
+		"Cell lookup: " << gridTime << " ns per query (" << gridHits << " of " << GRID_QUERIES << " hit)\n" <<
+		"Full scan:   " << scanTime << " ns per query (" << scanHits << " of " << SCAN_QUERIES << " hit)\n";
+	if (mismatches > 0) {
+		std::cout << mismatches << " queries disagree\n";
+		return -1;
+	}
+	return 0;
+}
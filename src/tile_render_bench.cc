@@ -0,0 +1,152 @@
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "LTexture.hh"
+#include "TileMap.hh"
+#include "Tile.hh"
+#include "LPerfTimer.hh"
+
+#define SCREEN_WIDTH (640)
+#define SCREEN_HEIGHT (480)
+#define TILE_WIDTH (80)
+#define TILE_HEIGHT (80)
+#define TOTAL_TILE_SPRITES (12)
+#define FRAMES (60)
+
+// Renders a camera's view of square tile maps of growing size with the
+// software renderer, through TileMap's culled batch and by testing every
+// tile against the camera like the old Tile::render
+// Usage: tile_render_bench
+
+bool init(SDL_Surface**, SDL_Renderer**);
+bool makeSheet(LTexture*, SDL_Rect*, SDL_Renderer*);
+bool makeMap(const char*, int);
+void closeSDL(SDL_Surface**, SDL_Renderer**);
+
+// Render into a surface so no window or display is needed
+bool init(SDL_Surface** screen, SDL_Renderer** renderer) {
+	if (SDL_Init(0) < 0) {
+		std::cout << "Init Error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+
+	*screen = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32,
+																					 SDL_PIXELFORMAT_ARGB8888);
+	if (*screen == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	*renderer = SDL_CreateSoftwareRenderer(*screen);
+	if (*renderer == NULL) {
+		std::cout << "Renderer creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+	return true;
+}
+
+// One row of differently colored tiles
+bool makeSheet(LTexture* sheet, SDL_Rect* tileClips, SDL_Renderer* renderer) {
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, TILE_WIDTH * TOTAL_TILE_SPRITES,
+																												TILE_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (surface == NULL) {
+		std::cout << "Surface creation error: " << SDL_GetError() << '\n';
+		return false;
+	}
+
+	for (int i = 0; i < TOTAL_TILE_SPRITES; i++) {
+		tileClips[i] = {i * TILE_WIDTH, 0, TILE_WIDTH, TILE_HEIGHT};
+		SDL_FillRect(surface, &tileClips[i], SDL_MapRGB(surface->format, i * 20, 0xff - i * 20, 0x80));
+	}
+
+	bool success = sheet->loadFromSurface(surface, renderer);
+	SDL_FreeSurface(surface);
+	return success;
+}
+
+bool makeMap(const char* path, int size) {
+	std::ofstream map(path);
+	for (int row = 0; row < size; row++) {
+		for (int col = 0; col < size; col++) {
+			map << rand() % TOTAL_TILE_SPRITES << ' ';
+		}
+		map << '\n';
+	}
+	if (map.fail()) {
+		std::cout << "Unable to write " << path << '\n';
+		return false;
+	}
+	return true;
+}
+
+void closeSDL(SDL_Surface** screen, SDL_Renderer** renderer) {
+	SDL_DestroyRenderer(*renderer);
+	*renderer = NULL;
+	SDL_FreeSurface(*screen);
+	*screen = NULL;
+
+	SDL_Quit();
+}
+
+int main(int argc, char** argv) {
+	SDL_Surface* screen = NULL;
+	SDL_Renderer* renderer = NULL;
+	LTexture sheet;
+	SDL_Rect tileClips[TOTAL_TILE_SPRITES];
+	const char* path = "tile_render_bench.map";
+	const int sizes[] = {100, 500, 2000};
+
+	srand(1);
+	if (!init(&screen, &renderer) || !makeSheet(&sheet, tileClips, renderer)) {
+		return -1;
+	}
+
+	std::cout << std::fixed << std::setprecision(3) << "ms per frame, " << FRAMES << " frames\n";
+	for (int size: sizes) {
+		TileMap tileMap;
+		bool loaded = makeMap(path, size) && tileMap.loadFromFile(path, size, size);
+		std::remove(path);
+		if (!loaded) {
+			return -1;
+		}
+
+		LPerfTimer culledTimer;
+		LPerfTimer scanTimer;
+		for (int frame = 0; frame < FRAMES; frame++) {
+			// Wander diagonally across the level
+			SDL_Rect camera = {frame * 997 % (tileMap.getLevelWidth() - SCREEN_WIDTH),
+												 frame * 991 % (tileMap.getLevelHeight() - SCREEN_HEIGHT),
+												 SCREEN_WIDTH, SCREEN_HEIGHT};
+
+			SDL_RenderClear(renderer);
+			culledTimer.start();
+			tileMap.render(renderer, camera, &sheet, tileClips);
+			SDL_RenderPresent(renderer);
+			culledTimer.lap();
+
+			SDL_RenderClear(renderer);
+			scanTimer.start();
+			for (int i = 0; i < tileMap.getTotalTiles(); i++) {
+				SDL_Rect box = tileMap.getBox(i);
+				if (checkCollision(camera, box)) {
+					sheet.render(renderer, box.x - camera.x, box.y - camera.y, &tileClips[tileMap.getType(i)]);
+				}
+			}
+			SDL_RenderPresent(renderer);
+			scanTimer.lap();
+		}
+
+		std::cout << size << "x" << size << ": culled batch " << culledTimer.getAverageLap() / 1000000 <<
+			", every tile " << scanTimer.getAverageLap() / 1000000 << '\n';
+	}
+
+	sheet.free();
+	closeSDL(&screen, &renderer);
+	return 0;
+}
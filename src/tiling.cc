@@ -6,10 +6,13 @@
 #include <cstdio>
 #include <cmath>
 #include <iostream>
-#include <fstream>
+#include <memory>
 
 #include "LTexture.hh"
 #include "Tile.hh"
+#include "TileMap.hh"
+#include "ChunkedWorld.hh"
+#include "TextureCache.hh"
 
 #define SCREEN_WIDTH (640)
 #define SCREEN_HEIGHT (480)
@@ -20,9 +23,9 @@
 #define TILE_WIDTH (80)
 #define TILE_HEIGHT (80)
 
-#define TOTAL_TILES (192)
 #define TOTAL_TILE_SPRITES (12)
 #define TICKS_PER_FRAME (1000 / 60)
+#define WORLD_MEMORY_BUDGET (16 * 1024 * 1024)
 
 enum textureInd {
 	DOTI,
@@ -30,9 +33,9 @@ enum textureInd {
 };
 
 bool init(SDL_Window**, SDL_Renderer**);
-bool loadMedia(LTexture*, SDL_Renderer*, Tile* tiles[]);
-bool setTiles(Tile* tiles[]);
-void closeSDL(SDL_Window**, SDL_Renderer**, LTexture*, int, Tile* tiles[]);
+bool loadMedia(std::shared_ptr<LTexture>*, TextureCache*, SDL_Rect*, SDL_Renderer*, TileMap*);
+void closeSDL(SDL_Window**, SDL_Renderer**, std::shared_ptr<LTexture>*, int, TextureCache*,
+							TileMap*);
 
 // Initialize SDL, Window, Renderer, Image, and TTF
 bool init(SDL_Window** window, SDL_Renderer** renderer) {
@@ -74,17 +77,20 @@ bool init(SDL_Window** window, SDL_Renderer** renderer) {
 	return true;
 }
 
-bool loadMedia(LTexture* textures, SDL_Rect* tileClips,
-							 SDL_Renderer* renderer, Tile* tiles[]) {
-	if (!textures[DOTI].loadFromFile("images/dot.bmp", renderer)) {
+bool loadMedia(std::shared_ptr<LTexture>* textures, TextureCache* cache,
+							 SDL_Rect* tileClips, SDL_Renderer* renderer, TileMap* tileMap) {
+	textures[DOTI] = cache->get("images/dot.bmp", renderer, 0xff, 0xff, 0xff);
+	if (textures[DOTI] == NULL) {
 		return false;
 	}
 
-	if (!textures[TILEI].loadFromFile("images/tiles.png", renderer)) {
+	textures[TILEI] = cache->get("images/tiles.png", renderer);
+	if (textures[TILEI] == NULL) {
 		return false;
 	}
 
-	if (!setTiles(tiles)) {
+	if (!tileMap->loadFromFile("files/lazy.map", LEVEL_WIDTH / TILE_WIDTH,
+														 LEVEL_HEIGHT / TILE_HEIGHT)) {
 		std::cout << "Tile load error\n";
 		return false;
 	}
@@ -105,55 +111,21 @@ bool loadMedia(LTexture* textures, SDL_Rect* tileClips,
 	return true;
 }
 
-bool setTiles(Tile* tiles[]) {
-	int x = 0;
-	int y = 0;
-
-	std::ifstream map("files/lazy.map");
-	if (map.fail()) {
-		std::cout << "Unable to load file\n";
-		return false;
-	}
-	for (int i = 0; i < TOTAL_TILES; i++) {
-		int tileType = TILE_RED;
-		map >> tileType;
-		if (map.fail()) {
-			std::cout << "Error reading from file\n";
-			return false;
-		}
-
-		if (tileType >= TILE_RED && tileType < TOTAL_TILE_SPRITES) {
-			tiles[i] = new Tile(x, y, (TileTypes) tileType);
-		} else {
-			std::cout << "Invalid Tile Type at " << i << '\n';
-			return false;
-		}
-
-		// Adjust x and y to be at correct tile position
-		x += TILE_WIDTH;
-		if (x >= LEVEL_WIDTH) {
-			x = 0;
-			y += TILE_HEIGHT;
-		}
-	}
-	map.close();
-	return true;
-}
-
 void closeSDL(SDL_Window** window, SDL_Renderer** renderer,
-							LTexture* textures, int numTextures, Tile* tiles[]) {
+							std::shared_ptr<LTexture>* textures, int numTextures,
+							TextureCache* cache, TileMap* tileMap) {
+	// Textures go before the renderer that owns them
 	for (int i = 0; i < numTextures; i++) {
-		textures[i].free();
+		textures[i].reset();
 	}
+	cache->clear();
 
 	SDL_DestroyRenderer(*renderer);
 	*renderer = NULL;
 	SDL_DestroyWindow(*window);
 	*window = NULL;
 
-	for (int i = 0; i < TOTAL_TILES; i++) {
-		delete tiles[i];
-	}
+	tileMap->free();
 
 	SDL_Quit();
 	IMG_Quit();
@@ -164,14 +136,23 @@ int main(int argc, char** argv) {
 	SDL_Window* window = NULL;
 	SDL_Renderer* renderer = NULL;
 
-	LTexture textures[2];
-	Tile* tiles[TOTAL_TILES];
+	TextureCache cache;
+	std::shared_ptr<LTexture> textures[2];
+	TileMap tileMap;
 	SDL_Rect tileClips[TOTAL_TILE_SPRITES];
 
 	if (!init(&window, &renderer)) {
 		return -1;
 	}
-	if (!loadMedia(textures, tileClips, renderer, tiles)) {
+	if (!loadMedia(textures, &cache, tileClips, renderer, &tileMap)) {
+		return -1;
+	}
+
+	// A chunked binary map (see map_convert) can be given to stream a world
+	// too large to load up front
+	ChunkedWorld world;
+	bool streaming = argc > 1;
+	if (streaming && !world.open(argv[1], WORLD_MEMORY_BUDGET)) {
 		return -1;
 	}
 
@@ -187,17 +168,25 @@ int main(int argc, char** argv) {
 			}
 			dot.handleEvent(e);
 		}
-		dot.move(tiles);
-		dot.setCamera(camera);
+		if (streaming) {
+			world.update(camera); // Request chunks before moving into them
+			dot.move(world);
+			dot.setCamera(camera, world.getLevelWidth(), world.getLevelHeight());
+		} else {
+			dot.move(tileMap);
+			dot.setCamera(camera, tileMap.getLevelWidth(), tileMap.getLevelHeight());
+		}
 
 		SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
 		SDL_RenderClear(renderer);
 	
-		for (int i = 0; i < TOTAL_TILES; i++) {
-			tiles[i]->render(renderer, camera, &textures[TILEI], tileClips);
+		if (streaming) {
+			world.render(renderer, camera, textures[TILEI].get(), tileClips);
+		} else {
+			tileMap.render(renderer, camera, textures[TILEI].get(), tileClips);
 		}
 
-		dot.render(renderer, &textures[DOTI], camera);
+		dot.render(renderer, textures[DOTI].get(), camera);
 
 		SDL_RenderPresent(renderer);
 
@@ -211,6 +200,7 @@ int main(int argc, char** argv) {
 		}
 	}
 
-	closeSDL(&window, &renderer, textures, 2, tiles);
+	world.close();
+	closeSDL(&window, &renderer, textures, 2, &cache, &tileMap);
 	return 0;
 }